@@ -0,0 +1,139 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "BenchmarkDb.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+[[nodiscard]] std::tuple<GeometryType, Dimension, std::string> ParseGeometryType(const std::string& geometry)
+{
+    static const std::unordered_map<std::string_view, GeometryType> GeometryTypes{
+        {"POINT", GeometryType::Point},
+        {"LINESTRING", GeometryType::Line},
+        {"POLYGON", GeometryType::Polygon},
+        {"MULTIPOINT", GeometryType::MultiPoint},
+        {"MULTILINESTRING", GeometryType::MultiLine},
+        {"MULTIPOLYGON", GeometryType::MultiPolygon}
+    };
+
+    static const std::array<std::pair<std::string_view, Dimension>, 3> Dimensions{{
+        {"ZM", Dimension::XYZM},
+        {"Z", Dimension::XYZ},
+        {"M", Dimension::XYM}
+    }};
+
+    auto spatialiteType = geometry.substr(0, geometry.find('('));
+    std::string_view type{spatialiteType};
+    auto dimension = Dimension::XY;
+    for (const auto& [suffix, suffixDimension] : Dimensions)
+    {
+        if (type.ends_with(suffix))
+        {
+            type.remove_suffix(suffix.size());
+            dimension = suffixDimension;
+            break;
+        }
+    }
+    return {GeometryTypes.at(type), dimension, std::move(spatialiteType)};
+}
+
+} // namespace
+
+BenchmarkDb* BenchmarkDb::s_instance = nullptr;
+
+[[nodiscard]] TableInfo GeometryTable::GetTableInfo(const AttributesInfo& attributes) const
+{
+    auto result = tableInfo;
+    result.attributes = attributes;
+    return result;
+}
+
+BenchmarkDb::BenchmarkDb()
+{
+    s_instance = this;
+}
+
+BenchmarkDb::~BenchmarkDb()
+{
+    m_tables.clear();
+    s_instance = nullptr;
+    std::filesystem::remove(m_driver.GetPath());
+}
+
+[[nodiscard]] BenchmarkDb& BenchmarkDb::Get()
+{
+    if (s_instance == nullptr)
+    {
+        throw std::logic_error{"Benchmark database is not created"};
+    }
+    return *s_instance;
+}
+
+[[nodiscard]] GeometryTable& BenchmarkDb::GetGeometryTable(
+    const std::string& geometry, 
+    size_t count, 
+    SpatialIndex spatialIndex)
+{
+    const auto key = fmt::format("{}/{}/{}", geometry, count, static_cast<int>(spatialIndex));
+    if (const auto it = m_tables.find(key); it != m_tables.end())
+    {
+        return *it->second;
+    }
+
+    const auto [geometryType, dimension, spatialiteType] = ParseGeometryType(geometry);
+    auto table = m_driver.CreateTable(fmt::format("geometries_{}", m_tables.size()), {
+        {"intAttribute", "INTEGER"},
+        {"doubleAttribute", "FLOAT"},
+        {"textAttribute", "TEXT"},
+        {"blobAttribute", "BLOB"}
+    });
+    table.AddGeometryColumn("geometry", spatialiteType);
+    table.CreateSpatialIndex(spatialIndex);
+
+    const std::string blob(128, 'A');
+    m_driver.Execute("BEGIN;");
+    for (size_t i = 0; i < count; ++i)
+    {
+        table.Insert(42, 6.66, "attribute value", Binary{blob}, ::Geometry{geometry});
+    }
+    m_driver.Execute("COMMIT;");
+
+    auto tableInfo = table.UpdateAndGetTableInfo(geometryType, dimension);
+    auto database = std::make_unique<Database>(m_driver.GetPath());
+    auto& result = *m_tables.emplace(key, std::make_unique<GeometryTable>(
+        std::move(table), std::move(tableInfo), std::move(database))).first->second;
+    return result;
+}
+
+[[nodiscard]] TestDbDriver& BenchmarkDb::GetDriver() noexcept
+{
+    return m_driver;
+}
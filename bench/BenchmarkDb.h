@@ -0,0 +1,89 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "TestDbDriver.h"
+
+#include <Database.h>
+#include <TableInfo.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Geometry table filled with copies of a single row, opened the same way as the datasource does
+ */
+struct GeometryTable
+{
+    /**
+     * @brief Get the info of the table with the given attributes,
+     *  the table has an attribute column per column type: 'intAttribute', 'doubleAttribute', 'textAttribute', 'blobAttribute'
+     */
+    [[nodiscard]] SpatialiteDatasource::TableInfo GetTableInfo(
+        const SpatialiteDatasource::AttributesInfo& attributes = {}) const;
+
+    Table table;
+    SpatialiteDatasource::TableInfo tableInfo; /// Without attributes
+    std::unique_ptr<SpatialiteDatasource::Database> database;
+};
+
+/**
+ * @brief Database shared by all benchmarks of the process, the tables are created on the first use
+ */
+class BenchmarkDb
+{
+public:
+    BenchmarkDb();
+    ~BenchmarkDb();
+
+    BenchmarkDb(const BenchmarkDb&) = delete;
+    BenchmarkDb& operator=(const BenchmarkDb&) = delete;
+
+    /**
+     * @brief Get the database of the running benchmarks
+     */
+    [[nodiscard]] static BenchmarkDb& Get();
+
+    /**
+     * @brief Get the table with the given number of rows, all with the same geometry and attributes.
+     *  It's created on the first call, the next calls return the same table
+     * 
+     * @param geometry Geometry in WKT format, e.g. 'LINESTRINGZ(1 2 3, 4 5 6)'
+     * @param count Number of rows
+     * @param spatialIndex Spatial index of the table
+     */
+    [[nodiscard]] GeometryTable& GetGeometryTable(
+        const std::string& geometry, 
+        size_t count, 
+        SpatialiteDatasource::SpatialIndex spatialIndex = SpatialiteDatasource::SpatialIndex::RTree);
+
+    [[nodiscard]] TestDbDriver& GetDriver() noexcept;
+
+    static constexpr SpatialiteDatasource::Mbr WorldMbr{-180, -90, 180, 90};
+
+private:
+    static BenchmarkDb* s_instance;
+
+    TestDbDriver m_driver;
+    std::unordered_map<std::string, std::unique_ptr<GeometryTable>> m_tables;
+};
@@ -0,0 +1,185 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "BenchmarkDb.h"
+#include "NullFeature.h"
+
+#include <GeometriesView.h>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+constexpr size_t PointsPerPart = 32;
+constexpr size_t PartsPerMultiGeometry = 4;
+
+/**
+ * @brief Format the coordinates of a point, adding z and/or m for the "Z", "M" and "ZM" dimension suffixes
+ */
+[[nodiscard]] std::string MakePoint(double x, double y, size_t i, std::string_view dimension)
+{
+    auto result = fmt::format("{} {}", x, y);
+    if (dimension.starts_with('Z'))
+        result += fmt::format(" {}", i % 3);
+    if (dimension.ends_with('M'))
+        result += fmt::format(" {}", i);
+    return result;
+}
+
+[[nodiscard]] std::string MakePoints(size_t offset, std::string_view dimension, bool isClosed)
+{
+    std::vector<std::string> points;
+    for (size_t i = 0; i < PointsPerPart; ++i)
+    {
+        const auto x = static_cast<double>(offset + i) / 10;
+        const auto y = static_cast<double>((offset + i) % 7) / 10;
+        points.push_back(MakePoint(x, y, i, dimension));
+    }
+    if (isClosed)
+    {
+        points.push_back(points.front());
+    }
+    return fmt::format("{}", fmt::join(points, ", "));
+}
+
+/**
+ * @brief Make a geometry of the type with 32 points per line or ring and 4 parts per multi-geometry
+ */
+[[nodiscard]] std::string MakeGeometry(std::string_view type, std::string_view dimension)
+{
+    std::vector<std::string> parts;
+    for (size_t i = 0; i < PartsPerMultiGeometry; ++i)
+    {
+        const auto offset = i * PointsPerPart;
+        if (type == "MULTIPOINT")
+            parts.push_back(fmt::format("({})", MakePoint(static_cast<double>(offset), 1, 1, dimension)));
+        else if (type == "MULTILINESTRING")
+            parts.push_back(fmt::format("({})", MakePoints(offset, dimension, false)));
+        else
+            parts.push_back(fmt::format("(({}))", MakePoints(offset, dimension, true)));
+    }
+
+    if (type == "POINT")
+        return fmt::format("POINT{}({})", dimension, MakePoint(1, 2, 3, dimension));
+    if (type == "LINESTRING")
+        return fmt::format("LINESTRING{}({})", dimension, MakePoints(0, dimension, false));
+    if (type == "POLYGON")
+        return fmt::format("POLYGON{}(({}))", dimension, MakePoints(0, dimension, true));
+    return fmt::format("{}{}({})", type, dimension, fmt::join(parts, ", "));
+}
+
+void BM_GeometriesViewIteration(benchmark::State& state)
+{
+    const auto rows = static_cast<size_t>(state.range(0));
+    auto& table = BenchmarkDb::Get().GetGeometryTable("POINT(1 2)", rows);
+    const auto tableInfo = table.GetTableInfo();
+
+    for (auto _ : state)
+    {
+        auto geometries = table.database->GetGeometries(tableInfo, BenchmarkDb::WorldMbr);
+        int64_t ids = 0;
+        for (auto it = geometries.begin(); it != geometries.end(); ++it)
+        {
+            ids += (*it).GetId();
+        }
+        benchmark::DoNotOptimize(ids);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+
+void BM_GeometryAddTo(benchmark::State& state, const std::string& geometry)
+{
+    auto& table = BenchmarkDb::Get().GetGeometryTable(geometry, 1);
+    const auto tableInfo = table.GetTableInfo();
+    auto geometries = table.database->GetGeometries(tableInfo, BenchmarkDb::WorldMbr);
+    auto row = *geometries.begin();
+
+    NullFeature feature;
+    for (auto _ : state)
+    {
+        row.AddTo(feature);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["vertices"] = benchmark::Counter(static_cast<double>(feature.points), benchmark::Counter::kIsRate);
+}
+
+void BM_AddAttributesTo(benchmark::State& state, const std::string& name, ColumnType type)
+{
+    auto& table = BenchmarkDb::Get().GetGeometryTable("POINT(1 2)", 1);
+    const auto tableInfo = table.GetTableInfo({{name, {type}}});
+    auto geometries = table.database->GetGeometries(tableInfo, BenchmarkDb::WorldMbr);
+    auto row = *geometries.begin();
+
+    NullFeature feature;
+    for (auto _ : state)
+    {
+        row.AddAttributesTo(feature);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_BlobToHex(benchmark::State& state)
+{
+    const std::vector<uint8_t> blob(static_cast<size_t>(state.range(0)), 0xAB);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(BlobToHex(blob.data(), static_cast<int>(blob.size())));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * blob.size()));
+}
+
+[[maybe_unused]] const auto IsRegistered = [] {
+    for (const auto* type : {"POINT", "LINESTRING", "POLYGON", "MULTIPOINT", "MULTILINESTRING", "MULTIPOLYGON"})
+    {
+        for (const auto* dimension : {"", "Z", "M", "ZM"})
+        {
+            benchmark::RegisterBenchmark(fmt::format("BM_GeometryAddTo/{}{}", type, dimension).c_str(), 
+                BM_GeometryAddTo, MakeGeometry(type, dimension));
+        }
+    }
+
+    const std::array<std::pair<std::string, ColumnType>, 4> attributes{{
+        {"intAttribute", ColumnType::Int64},
+        {"doubleAttribute", ColumnType::Double},
+        {"textAttribute", ColumnType::Text},
+        {"blobAttribute", ColumnType::Blob}
+    }};
+    for (const auto& [name, type] : attributes)
+    {
+        benchmark::RegisterBenchmark(fmt::format("BM_AddAttributesTo/{}", ColumnTypeToString(type)).c_str(), 
+            BM_AddAttributesTo, name, type);
+    }
+    return true;
+}();
+
+} // namespace
+
+BENCHMARK(BM_GeometriesViewIteration)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK(BM_BlobToHex)->RangeMultiplier(4)->Range(16, 4096);
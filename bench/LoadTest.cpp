@@ -0,0 +1,482 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * Load test of the datasource over HTTP: the datasource is started on a loopback port and
+ * N concurrent clients replay a mix of tile requests (browsing sessions at weighted zoom levels
+ * panning a viewport of tiles) and '/locate' requests. Throughput and latency percentiles
+ * per request type are printed and written to a JSON file.
+ */
+
+#include "Statistics.h"
+
+#include <ConfigLoader.h>
+#include <Datasource.h>
+
+#include <boost/program_options.hpp>
+#include <boost/scope_exit.hpp>
+#include <fmt/format.h>
+#include <httplib.h>
+#include <mapget/log.h>
+#include <mapget/model/feature.h>
+#include <nlohmann/json.hpp>
+#include <SQLiteCpp/Database.h>
+#include <SQLiteCpp/Statement.h>
+#include <sqlite3.h>
+#include <spatialite.h>
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace SpatialiteDatasource;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* LoopbackHost = "127.0.0.1";
+
+enum class PanPattern
+{
+    Random, /// Every pan goes to a random direction
+    Drag    /// Pans keep the direction of the session, like dragging the map across the screen
+};
+
+struct LoadTestOptions
+{
+    std::filesystem::path config;
+    std::filesystem::path map;
+    std::filesystem::path output{"load-test.json"};
+    size_t clients = 8;
+    double durationS = 30.;
+    std::vector<uint16_t> zoomLevels{9, 11, 13};
+    std::vector<double> zoomWeights; /// Uniform if empty
+    int viewport = 3; /// Tiles per side of the viewport
+    size_t pans = 10; /// Pans per browsing session
+    std::string panPattern = "drag";
+    double locateRatio = 0.05; /// Share of '/locate' requests
+    std::vector<double> extent{-10., 35., 30., 60.};
+    uint64_t seed = 1;
+};
+
+struct LocatableType
+{
+    std::string typeId;
+    int64_t maxRowId;
+};
+
+/**
+ * @brief What the clients learn about the datasource before the test
+ */
+struct Target
+{
+    std::string mapId;
+    std::vector<std::string> layers;
+    std::vector<LocatableType> locatableTypes;
+};
+
+/**
+ * @brief Latencies and counters of one request type, kept per client and merged after the test
+ */
+struct RequestStats
+{
+    std::vector<double> latenciesMs;
+    size_t failed = 0;
+    uint64_t bytes = 0;
+
+    void Merge(const RequestStats& other)
+    {
+        latenciesMs.insert(latenciesMs.end(), other.latenciesMs.begin(), other.latenciesMs.end());
+        failed += other.failed;
+        bytes += other.bytes;
+    }
+};
+
+struct ClientStats
+{
+    RequestStats tiles;
+    RequestStats locates;
+};
+
+[[nodiscard]] std::filesystem::path GetMapPath(const LoadTestOptions& options)
+{
+    if (!options.map.empty())
+    {
+        return options.map;
+    }
+    const auto config = YAML::LoadFile(options.config.string());
+    if (!config["map"] || !config["map"]["path"])
+    {
+        throw std::runtime_error{fmt::format("'{}' doesn't have 'map.path'", options.config.string())};
+    }
+    return config["map"]["path"].as<std::string>();
+}
+
+/**
+ * @brief Get the layers of the datasource from '/info' and the rowid ranges of their tables for '/locate'
+ */
+[[nodiscard]] Target GetTarget(uint16_t port, const std::filesystem::path& mapPath)
+{
+    httplib::Client client{LoopbackHost, port};
+    const auto response = client.Get("/info");
+    if (!response || response->status != 200)
+    {
+        throw std::runtime_error{"Failed to get '/info' of the datasource"};
+    }
+    const auto info = nlohmann::json::parse(response->body);
+
+    Target target;
+    target.mapId = info.at("mapId").get<std::string>();
+
+    SQLite::Database db{mapPath, SQLite::OPEN_READONLY};
+    for (const auto& [layerId, layer] : info.at("layers").items())
+    {
+        target.layers.push_back(layerId);
+        const auto typeId = layer.at("featureTypes").at(0).at("name").get<std::string>();
+        SQLite::Statement stmt{db, fmt::format("SELECT MAX(rowid) FROM \"{}\";", typeId)};
+        if (stmt.executeStep() && !stmt.getColumn(0).isNull())
+        {
+            target.locatableTypes.push_back({typeId, stmt.getColumn(0).getInt64()});
+        }
+    }
+    if (target.layers.empty())
+    {
+        throw std::runtime_error{"The datasource doesn't have any layers"};
+    }
+    return target;
+}
+
+/**
+ * @brief Tiles of the viewport centered at the given tile, x wraps around the antimeridian
+ */
+[[nodiscard]] std::set<uint64_t> GetViewport(int64_t centerX, int64_t centerY, uint16_t zoom, int viewport)
+{
+    const auto columns = int64_t{2} << zoom;
+    const auto rows = int64_t{1} << zoom;
+    std::set<uint64_t> tiles;
+    for (int64_t dy = -viewport / 2; dy < viewport - viewport / 2; ++dy)
+    {
+        const auto y = centerY + dy;
+        if (y < 0 || y >= rows)
+        {
+            continue;
+        }
+        for (int64_t dx = -viewport / 2; dx < viewport - viewport / 2; ++dx)
+        {
+            const auto x = ((centerX + dx) % columns + columns) % columns;
+            tiles.insert(mapget::TileId{static_cast<uint16_t>(x), static_cast<uint16_t>(y), zoom}.value_);
+        }
+    }
+    return tiles;
+}
+
+class LoadClient
+{
+public:
+    LoadClient(uint16_t port, const Target& target, const LoadTestOptions& options, uint64_t seed)
+        : m_client{LoopbackHost, port}
+        , m_target{target}
+        , m_options{options}
+        , m_random{seed}
+        , m_zoom{options.zoomWeights.empty() ? 
+            std::discrete_distribution<size_t>(options.zoomLevels.size(), 0., 1., [](double) { return 1.; }) :
+            std::discrete_distribution<size_t>(options.zoomWeights.begin(), options.zoomWeights.end())}
+    {
+        m_client.set_keep_alive(true);
+    }
+
+    /**
+     * @brief Replay browsing sessions until the deadline
+     */
+    void Run(Clock::time_point deadline)
+    {
+        std::uniform_real_distribution<double> lon{m_options.extent[0], m_options.extent[2]};
+        std::uniform_real_distribution<double> lat{m_options.extent[1], m_options.extent[3]};
+        std::uniform_int_distribution<int> direction{0, 3};
+        constexpr std::array<std::pair<int, int>, 4> Directions{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+
+        while (Clock::now() < deadline)
+        {
+            const auto zoom = m_options.zoomLevels[m_zoom(m_random)];
+            const auto start = mapget::TileId::fromWgs84(lon(m_random), lat(m_random), zoom);
+            int64_t x = start.x();
+            int64_t y = start.y();
+            auto sessionDirection = Directions[static_cast<size_t>(direction(m_random))];
+
+            std::set<uint64_t> visible;
+            for (size_t pan = 0; pan <= m_options.pans && Clock::now() < deadline; ++pan)
+            {
+                if (pan != 0)
+                {
+                    const auto [dx, dy] = m_options.panPattern == "drag" ? 
+                        sessionDirection : Directions[static_cast<size_t>(direction(m_random))];
+                    x += dx;
+                    y = std::clamp<int64_t>(y + dy, 0, (int64_t{1} << zoom) - 1);
+                }
+                auto viewport = GetViewport(x, y, zoom, m_options.viewport);
+                for (const auto tileId : viewport)
+                {
+                    if (visible.contains(tileId))
+                    {
+                        continue;
+                    }
+                    for (const auto& layer : m_target.layers)
+                    {
+                        RequestTile(layer, tileId);
+                        MaybeLocate();
+                    }
+                }
+                visible = std::move(viewport);
+            }
+        }
+    }
+
+    [[nodiscard]] const ClientStats& GetStats() const
+    {
+        return m_stats;
+    }
+
+private:
+    void RequestTile(const std::string& layer, uint64_t tileId)
+    {
+        const auto path = fmt::format("/tile?layer={}&tileId={}", layer, tileId);
+        const auto start = Clock::now();
+        const auto response = m_client.Get(path);
+        Record(m_stats.tiles, start, response);
+    }
+
+    /**
+     * @brief Locate a random feature with the configured probability,
+     * features of tiles nobody requested yet can't be located and are counted as failed
+     */
+    void MaybeLocate()
+    {
+        if (m_target.locatableTypes.empty() || m_locate(m_random) >= m_options.locateRatio)
+        {
+            return;
+        }
+        const auto& type = m_target.locatableTypes[
+            std::uniform_int_distribution<size_t>{0, m_target.locatableTypes.size() - 1}(m_random)];
+        const auto featureId = std::uniform_int_distribution<int64_t>{1, type.maxRowId}(m_random);
+        const nlohmann::json request{
+            {"mapId", m_target.mapId},
+            {"typeId", type.typeId},
+            {"featureId", nlohmann::json::array({"id", featureId})}};
+
+        const auto start = Clock::now();
+        const auto response = m_client.Post("/locate", request.dump(), "application/json");
+        Record(m_stats.locates, start, response);
+    }
+
+    static void Record(RequestStats& stats, Clock::time_point start, const httplib::Result& response)
+    {
+        stats.latenciesMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        if (!response || response->status != 200)
+        {
+            ++stats.failed;
+            return;
+        }
+        stats.bytes += response->body.size();
+    }
+
+    httplib::Client m_client;
+    const Target& m_target;
+    const LoadTestOptions& m_options;
+    std::mt19937_64 m_random;
+    std::discrete_distribution<size_t> m_zoom;
+    std::uniform_real_distribution<double> m_locate{0., 1.};
+    ClientStats m_stats;
+};
+
+[[nodiscard]] nlohmann::json Summarize(const RequestStats& stats, double elapsedS)
+{
+    const auto count = stats.latenciesMs.size();
+    double sum = 0.;
+    for (const auto latency : stats.latenciesMs)
+    {
+        sum += latency;
+    }
+    return {
+        {"count", count},
+        {"failed", stats.failed},
+        {"bytes", stats.bytes},
+        {"throughput", static_cast<double>(count) / elapsedS},
+        {"latencyMs", {
+            {"mean", count == 0 ? 0. : sum / static_cast<double>(count)},
+            {"p50", GetPercentile(stats.latenciesMs, 0.5)},
+            {"p95", GetPercentile(stats.latenciesMs, 0.95)},
+            {"p99", GetPercentile(stats.latenciesMs, 0.99)},
+            {"max", stats.latenciesMs.empty() ? 0. : *std::max_element(stats.latenciesMs.begin(), stats.latenciesMs.end())}}}};
+}
+
+void PrintSummary(const nlohmann::json& report)
+{
+    std::cout << fmt::format("{:<8} {:>10} {:>8} {:>12} {:>10} {:>10} {:>10}\n",
+        "request", "count", "failed", "requests/s", "p50 ms", "p95 ms", "p99 ms");
+    for (const auto* type : {"tile", "locate", "total"})
+    {
+        const auto& stats = report.at("requests").at(type);
+        const auto& latency = stats.at("latencyMs");
+        std::cout << fmt::format("{:<8} {:>10} {:>8} {:>12.1f} {:>10.2f} {:>10.2f} {:>10.2f}\n",
+            type, stats.at("count").get<size_t>(), stats.at("failed").get<size_t>(), stats.at("throughput").get<double>(),
+            latency.at("p50").get<double>(), latency.at("p95").get<double>(), latency.at("p99").get<double>());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    LoadTestOptions options;
+
+    po::options_description description{"Allowed options"};
+    description.add_options()
+        ("help,h", "produce help message")
+        ("config,c", po::value(&options.config), "path to a datasource config, e.g. written by map-generator")
+        ("map,m", po::value(&options.map), "path to a spatialite database, overrides the map of the config")
+        ("output,o", po::value(&options.output), "path to the JSON report (load-test.json by default)")
+        ("clients", po::value(&options.clients), "number of concurrent clients (8 by default)")
+        ("duration", po::value(&options.durationS), "duration of the test in seconds (30 by default)")
+        ("zoom-levels", po::value(&options.zoomLevels)->multitoken(), "zoom levels of the sessions (9 11 13 by default)")
+        ("zoom-weights", po::value(&options.zoomWeights)->multitoken(), "relative weights of the zoom levels (uniform by default)")
+        ("viewport", po::value(&options.viewport), "tiles per side of the viewport (3 by default)")
+        ("pans", po::value(&options.pans), "pans per session, every pan moves the viewport by one tile (10 by default)")
+        ("pan-pattern", po::value(&options.panPattern), "'drag' keeps the direction of a session, 'random' changes it on every pan (drag by default)")
+        ("locate-ratio", po::value(&options.locateRatio), "probability of a '/locate' request after a tile request (0.05 by default)")
+        ("extent", po::value(&options.extent)->multitoken(), "xmin ymin xmax ymax where sessions start (-10 35 30 60 by default)")
+        ("seed", po::value(&options.seed), "random seed of the request mix (1 by default)");
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, description), vm);
+        if (vm.contains("help"))
+        {
+            std::cout << description << std::endl;
+            return 1;
+        }
+        po::notify(vm);
+
+        if (options.config.empty() && options.map.empty())
+        {
+            throw std::runtime_error{"Either a config or a map must be provided"};
+        }
+        if (options.extent.size() != 4 || options.zoomLevels.empty() || options.clients == 0 || options.viewport <= 0)
+        {
+            throw std::runtime_error{"Extent must have 4 values, there must be at least 1 zoom level, client and tile in the viewport"};
+        }
+        if (!options.zoomWeights.empty() && options.zoomWeights.size() != options.zoomLevels.size())
+        {
+            throw std::runtime_error{"There must be a weight for every zoom level"};
+        }
+        if (options.panPattern != "drag" && options.panPattern != "random")
+        {
+            throw std::runtime_error{fmt::format("Unknown pan pattern '{}'", options.panPattern)};
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << description << std::endl;
+        return -1;
+    }
+
+    spatialite_initialize();
+    BOOST_SCOPE_EXIT(void) {
+        spatialite_shutdown();
+    } BOOST_SCOPE_EXIT_END
+
+    // Port 0 lets the system choose a free port
+    OverrideOptions overrideOptions;
+    overrideOptions.port = 0;
+    if (!options.map.empty())
+    {
+        overrideOptions.mapPath = options.map;
+    }
+    auto datasource = options.config.empty() ? 
+        CreateDatasourceDefaultConfig(overrideOptions) : CreateDatasource(options.config, overrideOptions);
+    const auto port = datasource.Start(LoopbackHost);
+    BOOST_SCOPE_EXIT(&datasource) {
+        datasource.Stop();
+    } BOOST_SCOPE_EXIT_END
+    mapget::log().info("Datasource is running on port {}", port);
+
+    const auto target = GetTarget(port, GetMapPath(options));
+
+    std::vector<LoadClient> clients;
+    clients.reserve(options.clients);
+    for (size_t i = 0; i < options.clients; ++i)
+    {
+        clients.emplace_back(port, target, options, options.seed + i);
+    }
+
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.durationS));
+    {
+        std::vector<std::jthread> threads;
+        for (auto& client : clients)
+        {
+            threads.emplace_back([&client, deadline] { client.Run(deadline); });
+        }
+    }
+    const auto elapsedS = std::chrono::duration<double>(Clock::now() - start).count();
+
+    RequestStats tiles;
+    RequestStats locates;
+    for (const auto& client : clients)
+    {
+        tiles.Merge(client.GetStats().tiles);
+        locates.Merge(client.GetStats().locates);
+    }
+    RequestStats total = tiles;
+    total.Merge(locates);
+
+    nlohmann::json report{
+        {"mapId", target.mapId},
+        {"clients", options.clients},
+        {"durationS", elapsedS},
+        {"zoomLevels", options.zoomLevels},
+        {"zoomWeights", options.zoomWeights},
+        {"viewport", options.viewport},
+        {"pans", options.pans},
+        {"panPattern", options.panPattern},
+        {"locateRatio", options.locateRatio},
+        {"seed", options.seed},
+        {"requests", {
+            {"tile", Summarize(tiles, elapsedS)},
+            {"locate", Summarize(locates, elapsedS)},
+            {"total", Summarize(total, elapsedS)}}}};
+
+    PrintSummary(report);
+    std::ofstream{options.output} << report.dump(2) << std::endl;
+    std::cerr << fmt::format("Report: '{}'\n", options.output.string());
+    return 0;
+}
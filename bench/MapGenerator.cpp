@@ -0,0 +1,464 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * Generates a reproducible synthetic map of the given size for load tests:
+ * roads (long linestrings), POIs (dense points), buildings (polygons), their 3D variants
+ * and relation tables, with R*Tree spatial indexes. Next to the map, a datasource config
+ * with the relations of the generated layers is written.
+ */
+
+#include "TestDbDriver.h"
+
+#include <UniqueGaiaGeomCollPtr.h>
+#include <Mbr.h>
+
+#include <boost/program_options.hpp>
+#include <boost/scope_exit.hpp>
+#include <fmt/format.h>
+#include <sqlite3.h>
+#include <spatialite.h>
+#include <spatialite/gg_const.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace SpatialiteDatasource;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t MiB = 1024 * 1024;
+constexpr size_t PoiCategoriesCount = 64;
+constexpr std::array Surfaces{"asphalt", "concrete", "paving_stones", "gravel", "dirt"};
+
+/**
+ * @brief Share of the target size taken by the spatial indexes, the tables are filled up to the rest
+ */
+constexpr double SpatialIndexesShare = 0.15;
+
+struct GeneratorOptions
+{
+    std::filesystem::path output;
+    uint64_t seed = 1;
+    uint64_t targetMiB = 1024;
+    std::vector<double> extent{-10., 35., 30., 60.};
+    size_t cities = 1000;
+    bool analyze = false;
+};
+
+/**
+ * @brief Number of features of each layer inserted in a single transaction, also sets the proportions of the layers
+ */
+struct RoundSize
+{
+    size_t roads = 100;
+    size_t pois = 1000;
+    size_t buildings = 600;
+    size_t roads3d = 20;
+    size_t pois3d = 200;
+    size_t buildings3d = 120;
+};
+
+class MapGenerator
+{
+public:
+    explicit MapGenerator(const GeneratorOptions& options)
+        : m_options{options}
+        , m_extent{options.extent[0], options.extent[1], options.extent[2], options.extent[3]}
+        , m_random{options.seed}
+        , m_db{options.output}
+    {
+        // the map is written once and can be regenerated, so durability is traded for speed
+        m_db.Execute("PRAGMA journal_mode = OFF;");
+        m_db.Execute("PRAGMA synchronous = OFF;");
+        m_db.Execute("PRAGMA cache_size = -262144;");
+
+        std::uniform_real_distribution<double> x{m_extent.xmin, m_extent.xmax};
+        std::uniform_real_distribution<double> y{m_extent.ymin, m_extent.ymax};
+        for (size_t i = 0; i < options.cities; ++i)
+        {
+            m_cities.push_back({x(m_random), y(m_random)});
+        }
+    }
+
+    void Generate()
+    {
+        const auto start = Clock::now();
+        CreateTables();
+
+        const auto tablesBytes = static_cast<uint64_t>(
+            static_cast<double>(m_options.targetMiB * MiB) * (1. - SpatialIndexesShare));
+        uint64_t reportedMiB = 0;
+        for (auto size = GetSize(); size < tablesBytes; size = GetSize())
+        {
+            InsertRound();
+            if (const auto sizeMiB = size / MiB; sizeMiB >= reportedMiB + 1024)
+            {
+                reportedMiB = sizeMiB;
+                std::cerr << fmt::format("{} MiB of {} MiB, {}s\n", sizeMiB, tablesBytes / MiB, GetSeconds(start));
+            }
+        }
+        std::cerr << fmt::format("Tables are filled in {}s: {} roads, {} POIs, {} buildings\n", 
+            GetSeconds(start), m_roadsCount, m_poisCount, m_buildingsCount);
+
+        for (const auto* table : {"roads", "pois", "buildings", "roads_3d", "pois_3d", "buildings_3d"})
+        {
+            ExecuteSpatialite(fmt::format("SELECT CreateSpatialIndex('{}', 'geometry');", table));
+            std::cerr << fmt::format("Spatial index of '{}' is created, {}s\n", table, GetSeconds(start));
+        }
+        if (m_options.analyze)
+        {
+            m_db.Execute("ANALYZE;");
+        }
+        std::cerr << fmt::format("Generated {} MiB in {}s\n", GetSize() / MiB, GetSeconds(start));
+    }
+
+    void WriteConfig(const std::filesystem::path& path) const
+    {
+        std::ofstream config{path};
+        config << fmt::format(R"YAML(map:
+  name: synthetic-{seed}
+  path: {path}
+
+layers:
+- table: roads
+  attributes:
+  - name: lanes
+    relation:
+      relatedColumns: [road_details.lanes]
+      matchCondition: road_details.road_id = layerTable.id
+  - name: surface
+    relation:
+      relatedColumns: [road_details.surface]
+      matchCondition: road_details.road_id = layerTable.id
+- table: pois
+  attributes:
+  - name: category
+    relation:
+      relatedColumns: [poi_categories.name]
+      matchCondition: poi_categories.id = layerTable.category_id
+- table: buildings
+- table: roads_3d
+- table: pois_3d
+- table: buildings_3d
+)YAML", fmt::arg("seed", m_options.seed), fmt::arg("path", std::filesystem::absolute(m_options.output).string()));
+    }
+
+private:
+    void CreateTables()
+    {
+        const auto createTable = [this](std::string_view table, std::string_view columns, std::string_view geometry) {
+            m_db.Execute(fmt::format("CREATE TABLE {} (id INTEGER PRIMARY KEY AUTOINCREMENT, {});", table, columns));
+            ExecuteSpatialite(fmt::format("SELECT AddGeometryColumn('{}', 'geometry', {}, '{}');", table, Wgs84Srid, geometry));
+        };
+        for (const auto* suffix : {"", "_3d"})
+        {
+            const auto z = std::string_view{suffix}.empty() ? "" : "Z";
+            createTable(fmt::format("roads{}", suffix), "road_class INTEGER, name TEXT, max_speed FLOAT", 
+                fmt::format("LINESTRING{}", z));
+            createTable(fmt::format("pois{}", suffix), "category_id INTEGER, name TEXT", fmt::format("POINT{}", z));
+            createTable(fmt::format("buildings{}", suffix), "height FLOAT, levels INTEGER", fmt::format("POLYGON{}", z));
+        }
+
+        m_db.Execute("CREATE TABLE road_details (road_id INTEGER PRIMARY KEY, lanes INTEGER, surface TEXT);");
+        m_db.Execute("CREATE TABLE poi_categories (id INTEGER PRIMARY KEY, name TEXT);");
+        for (size_t i = 0; i < PoiCategoriesCount; ++i)
+        {
+            m_db.Execute(fmt::format("INSERT INTO poi_categories VALUES ({}, 'category {}');", i, i));
+        }
+
+        auto& db = m_db.GetDatabase();
+        for (const auto* suffix : {"", "_3d"})
+        {
+            m_statements.push_back({
+                .roads{db, fmt::format("INSERT INTO roads{} (road_class, name, max_speed, geometry) VALUES (?, ?, ?, ?);", suffix)},
+                .pois{db, fmt::format("INSERT INTO pois{} (category_id, name, geometry) VALUES (?, ?, ?);", suffix)},
+                .buildings{db, fmt::format("INSERT INTO buildings{} (height, levels, geometry) VALUES (?, ?, ?);", suffix)}
+            });
+        }
+        m_roadDetails.emplace(db, "INSERT INTO road_details (road_id, lanes, surface) VALUES (?, ?, ?);");
+    }
+
+    void InsertRound()
+    {
+        static constexpr RoundSize Round;
+
+        m_db.Execute("BEGIN;");
+        for (const auto hasZ : {false, true})
+        {
+            auto& [roads, pois, buildings] = m_statements[hasZ ? 1 : 0];
+            for (size_t i = 0; i < (hasZ ? Round.roads3d : Round.roads); ++i)
+            {
+                InsertRoad(roads, hasZ);
+            }
+            for (size_t i = 0; i < (hasZ ? Round.pois3d : Round.pois); ++i)
+            {
+                InsertPoi(pois, hasZ);
+            }
+            for (size_t i = 0; i < (hasZ ? Round.buildings3d : Round.buildings); ++i)
+            {
+                InsertBuilding(buildings, hasZ);
+            }
+        }
+        m_db.Execute("COMMIT;");
+    }
+
+    void InsertRoad(SQLite::Statement& stmt, bool hasZ)
+    {
+        const auto roadClass = std::uniform_int_distribution<int>{1, 7}(m_random);
+        // main roads are longer and have fewer, longer segments
+        const auto points = std::uniform_int_distribution<int>{8, roadClass <= 2 ? 1000 : 200}(m_random);
+        const auto segmentLength = 0.0002 * (8 - roadClass);
+
+        UniqueGaiaGeomCollPtr geometry{hasZ ? gaiaAllocGeomCollXYZ() : gaiaAllocGeomColl()};
+        geometry->Srid = Wgs84Srid;
+        geometry->DeclaredType = GAIA_LINESTRING;
+        auto* line = gaiaAddLinestringToGeomColl(geometry.get(), points);
+        auto [x, y] = GetPointNearCity(0.2);
+        auto heading = std::uniform_real_distribution<double>{0., 2 * std::numbers::pi}(m_random);
+        auto z = std::uniform_real_distribution<double>{0., 500.}(m_random);
+        std::normal_distribution<double> turn{0., 0.15};
+        std::normal_distribution<double> climb{0., 0.5};
+        for (int i = 0; i < points; ++i)
+        {
+            if (hasZ)
+            {
+                gaiaSetPointXYZ(line->Coords, i, x, y, z);
+            }
+            else
+            {
+                gaiaSetPoint(line->Coords, i, x, y);
+            }
+            heading += turn(m_random);
+            x = std::clamp(x + std::cos(heading) * segmentLength, m_extent.xmin, m_extent.xmax);
+            y = std::clamp(y + std::sin(heading) * segmentLength, m_extent.ymin, m_extent.ymax);
+            z += climb(m_random);
+        }
+
+        stmt.bind(1, roadClass);
+        stmt.bind(2, fmt::format("Road {}", m_roadsCount));
+        stmt.bind(3, 10. * std::uniform_int_distribution<int>{3, 13}(m_random));
+        BindGeometry(stmt, 4, std::move(geometry));
+        Insert(stmt);
+        ++m_roadsCount;
+
+        if (!hasZ)
+        {
+            m_roadDetails->bind(1, m_db.GetDatabase().getLastInsertRowid());
+            m_roadDetails->bind(2, std::uniform_int_distribution<int>{1, roadClass <= 2 ? 4 : 2}(m_random));
+            m_roadDetails->bind(3, Surfaces[std::uniform_int_distribution<size_t>{0, Surfaces.size() - 1}(m_random)]);
+            Insert(*m_roadDetails);
+        }
+    }
+
+    void InsertPoi(SQLite::Statement& stmt, bool hasZ)
+    {
+        const auto [x, y] = GetPointNearCity(0.05);
+        UniqueGaiaGeomCollPtr geometry{hasZ ? gaiaAllocGeomCollXYZ() : gaiaAllocGeomColl()};
+        geometry->Srid = Wgs84Srid;
+        geometry->DeclaredType = GAIA_POINT;
+        if (hasZ)
+            gaiaAddPointToGeomCollXYZ(geometry.get(), x, y, std::uniform_real_distribution<double>{0., 100.}(m_random));
+        else
+            gaiaAddPointToGeomColl(geometry.get(), x, y);
+
+        stmt.bind(1, std::uniform_int_distribution<int>{0, PoiCategoriesCount - 1}(m_random));
+        stmt.bind(2, fmt::format("POI {}", m_poisCount));
+        BindGeometry(stmt, 3, std::move(geometry));
+        Insert(stmt);
+        ++m_poisCount;
+    }
+
+    void InsertBuilding(SQLite::Statement& stmt, bool hasZ)
+    {
+        // a rotated rectangle with some of the sides broken, like a typical building footprint
+        const auto [centerX, centerY] = GetPointNearCity(0.03);
+        const auto corners = std::uniform_int_distribution<int>{4, 12}(m_random);
+        const auto radius = std::uniform_real_distribution<double>{0.00005, 0.0003}(m_random);
+        const auto rotation = std::uniform_real_distribution<double>{0., std::numbers::pi / 2}(m_random);
+        const auto height = std::uniform_real_distribution<double>{3., 60.}(m_random);
+
+        UniqueGaiaGeomCollPtr geometry{hasZ ? gaiaAllocGeomCollXYZ() : gaiaAllocGeomColl()};
+        geometry->Srid = Wgs84Srid;
+        geometry->DeclaredType = GAIA_POLYGON;
+        auto* ring = gaiaAddPolygonToGeomColl(geometry.get(), corners + 1, 0)->Exterior;
+        for (int i = 0; i <= corners; ++i)
+        {
+            const auto angle = rotation + 2 * std::numbers::pi * (i % corners) / corners;
+            const auto x = centerX + std::cos(angle) * radius;
+            const auto y = centerY + std::sin(angle) * radius;
+            if (hasZ)
+            {
+                gaiaSetPointXYZ(ring->Coords, i, x, y, height);
+            }
+            else
+            {
+                gaiaSetPoint(ring->Coords, i, x, y);
+            }
+        }
+
+        stmt.bind(1, height);
+        stmt.bind(2, static_cast<int>(height / 3));
+        BindGeometry(stmt, 3, std::move(geometry));
+        Insert(stmt);
+        ++m_buildingsCount;
+    }
+
+    [[nodiscard]] std::pair<double, double> GetPointNearCity(double spread)
+    {
+        const auto& [cityX, cityY] = m_cities[std::uniform_int_distribution<size_t>{0, m_cities.size() - 1}(m_random)];
+        std::normal_distribution<double> offset{0., spread};
+        return {
+            std::clamp(cityX + offset(m_random), m_extent.xmin, m_extent.xmax),
+            std::clamp(cityY + offset(m_random), m_extent.ymin, m_extent.ymax)
+        };
+    }
+
+    /**
+     * @brief Execute a spatialite function that returns 1 on success
+     */
+    void ExecuteSpatialite(const std::string& sql)
+    {
+        SQLite::Statement stmt{m_db.GetDatabase(), sql};
+        if (!stmt.executeStep() || stmt.getColumn(0).getInt() != 1)
+        {
+            throw std::runtime_error{fmt::format("Failed to execute '{}'", sql)};
+        }
+    }
+
+    static void BindGeometry(SQLite::Statement& stmt, int index, UniqueGaiaGeomCollPtr geometry)
+    {
+        unsigned char* blob = nullptr;
+        int size = 0;
+        gaiaToSpatiaLiteBlobWkb(geometry.get(), &blob, &size);
+        stmt.bind(index, blob, size);
+        gaiaFree(blob);
+    }
+
+    static void Insert(SQLite::Statement& stmt)
+    {
+        stmt.exec();
+        stmt.reset();
+    }
+
+    [[nodiscard]] uint64_t GetSize()
+    {
+        SQLite::Statement stmt{m_db.GetDatabase(), 
+            "SELECT page_count * page_size FROM pragma_page_count(), pragma_page_size();"};
+        stmt.executeStep();
+        return static_cast<uint64_t>(stmt.getColumn(0).getInt64());
+    }
+
+    [[nodiscard]] static int64_t GetSeconds(Clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - start).count();
+    }
+
+private:
+    struct Statements
+    {
+        SQLite::Statement roads;
+        SQLite::Statement pois;
+        SQLite::Statement buildings;
+    };
+
+    const GeneratorOptions& m_options;
+    const Mbr m_extent;
+    std::mt19937_64 m_random;
+    std::vector<std::pair<double, double>> m_cities;
+
+    TestDbDriver m_db;
+    std::vector<Statements> m_statements; /// 2D and 3D tables
+    std::optional<SQLite::Statement> m_roadDetails;
+    uint64_t m_roadsCount = 0;
+    uint64_t m_poisCount = 0;
+    uint64_t m_buildingsCount = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    GeneratorOptions options;
+
+    po::options_description description{"Allowed options"};
+    description.add_options()
+        ("help,h", "produce help message")
+        ("output,o", po::value(&options.output)->required(), "path to the generated map, must not exist")
+        ("seed", po::value(&options.seed), "random seed, the same seed and size produce the same map (1 by default)")
+        ("size", po::value(&options.targetMiB), "target size of the map in MiB (1024 by default)")
+        ("extent", po::value(&options.extent)->multitoken(), "xmin ymin xmax ymax of the map (-10 35 30 60 by default)")
+        ("cities", po::value(&options.cities), "number of cities the features are clustered around (1000 by default)")
+        ("analyze", po::bool_switch(&options.analyze), "run ANALYZE on the generated map");
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, description), vm);
+        if (vm.contains("help"))
+        {
+            std::cout << description << std::endl;
+            return 1;
+        }
+        po::notify(vm);
+
+        if (options.extent.size() != 4 || options.cities == 0)
+        {
+            throw std::runtime_error{"Extent must have 4 values and there must be at least 1 city"};
+        }
+        if (std::filesystem::exists(options.output))
+        {
+            throw std::runtime_error{fmt::format("'{}' already exists", options.output.string())};
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << description << std::endl;
+        return -1;
+    }
+
+    spatialite_initialize();
+    BOOST_SCOPE_EXIT(void) {
+        spatialite_shutdown();
+    } BOOST_SCOPE_EXIT_END
+
+    const auto configPath = std::filesystem::path{options.output}.replace_extension(".yaml");
+    {
+        MapGenerator generator{options};
+        generator.Generate();
+        generator.WriteConfig(configPath);
+    }
+    std::cerr << fmt::format("Datasource config: '{}'\n", configPath.string());
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "IFeature.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+/**
+ * @brief Feature that drops everything added to it, so only the decoding is measured
+ */
+class NullFeature : public SpatialiteDatasource::IFeature
+{
+    class NullGeometry : public SpatialiteDatasource::IGeometry
+    {
+    public:
+        explicit NullGeometry(uint64_t& points) noexcept
+            : m_points{points}
+        {}
+
+        void AddPoint(const mapget::Point& point) override
+        {
+            benchmark::DoNotOptimize(point);
+            ++m_points;
+        }
+
+    private:
+        uint64_t& m_points;
+    };
+
+public:
+    SpatialiteDatasource::IGeometry& AddGeometry(
+        SpatialiteDatasource::GeometryType, size_t) override
+    {
+        return m_geometry;
+    }
+
+    void AddAttribute(std::string_view, int64_t value) override { benchmark::DoNotOptimize(value); }
+    void AddAttribute(std::string_view, double value) override { benchmark::DoNotOptimize(value); }
+    void AddAttribute(std::string_view, std::string_view value) override { benchmark::DoNotOptimize(value); }
+
+    uint64_t points = 0;
+
+private:
+    NullGeometry m_geometry{points};
+};
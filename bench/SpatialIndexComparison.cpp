@@ -0,0 +1,273 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * Compares the spatial index strategies on generated tables:
+ * for every table size and density, a table of random points is created with all spatial indexes
+ * the build supports, and 'GetGeometries' is measured on random tiles of several zoom levels for every index.
+ * The data is the same for all indexes, so the results are directly comparable.
+ */
+
+#include "Statistics.h"
+#include "TestDbDriver.h"
+
+#include <Database.h>
+#include <TileBatcher.h>
+
+#include <boost/program_options.hpp>
+#include <boost/scope_exit.hpp>
+#include <fmt/format.h>
+#include <mapget/log.h>
+#include <sqlite3.h>
+#include <spatialite.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace SpatialiteDatasource;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double CenterX = 10.;
+constexpr double CenterY = 50.;
+
+struct ComparisonOptions
+{
+    std::vector<size_t> sizes{10'000, 100'000, 1'000'000, 10'000'000};
+    std::vector<double> densities{100., 10'000.}; /// Features per square degree
+    std::vector<uint16_t> zoomLevels{8, 11, 14};
+    size_t queries = 20;
+    uint32_t seed = 42;
+};
+
+struct Measurement
+{
+    size_t size;
+    double density;
+    uint16_t zoomLevel;
+    SpatialIndex spatialIndex;
+    double meanRows;
+    double p50Ms;
+    double p95Ms;
+    double featuresPerSecond;
+};
+
+[[nodiscard]] std::vector<SpatialIndex> GetSupportedSpatialIndexes()
+{
+#if NAVINFO_INTERNAL_BUILD
+    return {SpatialIndex::None, SpatialIndex::RTree, SpatialIndex::MbrCache, SpatialIndex::NavInfo};
+#else
+    return {SpatialIndex::None, SpatialIndex::RTree, SpatialIndex::MbrCache};
+#endif
+}
+
+[[nodiscard]] std::string_view ToString(SpatialIndex spatialIndex)
+{
+    switch (spatialIndex)
+    {
+    case SpatialIndex::None: return "None";
+    case SpatialIndex::RTree: return "RTree";
+    case SpatialIndex::MbrCache: return "MbrCache";
+    case SpatialIndex::NavInfo: return "NavInfo";
+    }
+    return "Unknown";
+}
+
+[[nodiscard]] Mbr GetExtent(size_t size, double density)
+{
+    const auto halfSide = std::min(std::sqrt(static_cast<double>(size) / density), 170.) / 2;
+    return {CenterX - halfSide, CenterY - halfSide / 2, CenterX + halfSide, CenterY + halfSide / 2};
+}
+
+/**
+ * @brief Fill the table with random points within the extent in a single transaction
+ */
+void InsertPoints(TestDbDriver& db, const Table& table, size_t size, const Mbr& extent, std::mt19937& random)
+{
+    std::uniform_real_distribution<double> x{extent.xmin, extent.xmax};
+    std::uniform_real_distribution<double> y{extent.ymin, extent.ymax};
+
+    db.Execute("BEGIN;");
+    SQLite::Statement stmt{db.GetDatabase(), fmt::format(
+        "INSERT INTO {} (geometry) VALUES (MakePoint(?, ?, {}));", table.name, Wgs84Srid)};
+    for (size_t i = 0; i < size; ++i)
+    {
+        stmt.bind(1, x(random));
+        stmt.bind(2, y(random));
+        stmt.exec();
+        stmt.reset();
+    }
+    db.Execute("COMMIT;");
+}
+
+[[nodiscard]] std::vector<Measurement> Compare(size_t size, double density, const ComparisonOptions& options)
+{
+    std::mt19937 random{options.seed};
+    const auto extent = GetExtent(size, density);
+    const auto spatialIndexes = GetSupportedSpatialIndexes();
+
+    TestDbDriver db;
+    BOOST_SCOPE_EXIT_ALL(&db) {
+        std::filesystem::remove(db.GetPath());
+    };
+
+    const auto generationStart = Clock::now();
+    auto table = db.CreateTable("points", {});
+    table.AddGeometryColumn("geometry", "POINT");
+    InsertPoints(db, table, size, extent, random);
+    // all indexes are built on the same table, the query decides which one is used
+    for (const auto spatialIndex : spatialIndexes)
+    {
+        table.CreateSpatialIndex(spatialIndex);
+    }
+    std::cerr << fmt::format("Generated {} points with density {}/deg² in {}s\n", size, density,
+        std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - generationStart).count());
+
+    const Database database{db.GetPath()};
+    auto tableInfo = table.UpdateAndGetTableInfo(GeometryType::Point, Dimension::XY);
+
+    std::vector<Measurement> measurements;
+    for (const auto zoomLevel : options.zoomLevels)
+    {
+        std::uniform_real_distribution<double> x{extent.xmin, extent.xmax};
+        std::uniform_real_distribution<double> y{extent.ymin, extent.ymax};
+        std::vector<Mbr> tiles;
+        for (size_t i = 0; i < options.queries; ++i)
+        {
+            tiles.push_back(GetTileMbr(mapget::TileId::fromWgs84(x(random), y(random), zoomLevel)));
+        }
+
+        for (const auto spatialIndex : spatialIndexes)
+        {
+            auto indexTableInfo = tableInfo;
+            indexTableInfo.spatialIndex = spatialIndex;
+
+            std::vector<double> latencies;
+            size_t rows = 0;
+            for (const auto& tile : tiles)
+            {
+                const auto start = Clock::now();
+                auto geometries = database.GetGeometries(indexTableInfo, tile);
+                for (auto it = geometries.begin(); it != geometries.end(); ++it)
+                {
+                    ++rows;
+                }
+                latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            }
+
+            double totalMs = 0;
+            for (const auto latency : latencies)
+                totalMs += latency;
+            measurements.push_back({
+                .size = size,
+                .density = density,
+                .zoomLevel = zoomLevel,
+                .spatialIndex = spatialIndex,
+                .meanRows = static_cast<double>(rows) / static_cast<double>(tiles.size()),
+                .p50Ms = GetPercentile(latencies, 0.5),
+                .p95Ms = GetPercentile(latencies, 0.95),
+                .featuresPerSecond = totalMs > 0 ? static_cast<double>(rows) / totalMs * 1000 : 0.
+            });
+        }
+    }
+    return measurements;
+}
+
+void PrintComparison(const std::vector<Measurement>& measurements)
+{
+    std::cout << fmt::format("{:>10} {:>10} {:>5} {:>9} {:>10} {:>10} {:>10} {:>14} {}\n",
+        "features", "density", "zoom", "index", "rows/tile", "p50 ms", "p95 ms", "features/s", "");
+    for (auto it = measurements.begin(); it != measurements.end();)
+    {
+        // measurements of the same table and zoom level are adjacent, the fastest one is marked
+        const auto groupEnd = std::find_if(it, measurements.end(), [&it](const Measurement& m) {
+            return m.size != it->size || m.density != it->density || m.zoomLevel != it->zoomLevel;
+        });
+        const auto best = std::min_element(it, groupEnd, [](const Measurement& lhs, const Measurement& rhs) {
+            return lhs.p50Ms < rhs.p50Ms;
+        });
+        for (; it != groupEnd; ++it)
+        {
+            std::cout << fmt::format("{:>10} {:>10} {:>5} {:>9} {:>10.1f} {:>10.3f} {:>10.3f} {:>14.0f} {}\n",
+                it->size, it->density, it->zoomLevel, ToString(it->spatialIndex), it->meanRows, 
+                it->p50Ms, it->p95Ms, it->featuresPerSecond, it == best ? "<- best" : "");
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    ComparisonOptions options;
+
+    po::options_description description{"Allowed options"};
+    description.add_options()
+        ("help,h", "produce help message")
+        ("sizes", po::value(&options.sizes)->multitoken(), "numbers of features in the generated tables (10000 100000 1000000 10000000 by default)")
+        ("densities", po::value(&options.densities)->multitoken(), "features per square degree (100 10000 by default)")
+        ("zoom-levels", po::value(&options.zoomLevels)->multitoken(), "zoom levels of the queried tiles (8 11 14 by default)")
+        ("queries", po::value(&options.queries), "number of random tiles per zoom level (20 by default)")
+        ("seed", po::value(&options.seed), "random seed (42 by default)");
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, description), vm);
+        if (vm.contains("help"))
+        {
+            std::cout << description << std::endl;
+            return 1;
+        }
+        po::notify(vm);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << description << std::endl;
+        return -1;
+    }
+
+    mapget::log().set_level(spdlog::level::warn);
+    spatialite_initialize();
+    BOOST_SCOPE_EXIT(void) {
+        spatialite_shutdown();
+    } BOOST_SCOPE_EXIT_END
+
+    std::vector<Measurement> measurements;
+    for (const auto size : options.sizes)
+    {
+        for (const auto density : options.densities)
+        {
+            auto result = Compare(size, density, options);
+            measurements.insert(measurements.end(), result.begin(), result.end());
+        }
+    }
+    PrintComparison(measurements);
+    return 0;
+}
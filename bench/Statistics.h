@@ -0,0 +1,43 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Get the percentile of the values by the nearest rank, 0 if there are no values
+ * 
+ * @param values Values, taken by copy since they're partially sorted
+ * @param percentile Percentile in [0, 1]
+ */
+[[nodiscard]] inline double GetPercentile(std::vector<double> values, double percentile)
+{
+    if (values.empty())
+    {
+        return 0.;
+    }
+    const auto index = static_cast<size_t>(percentile * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<ptrdiff_t>(index), values.end());
+    return values[index];
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "BufferedFeature.h"
+#include "GeometryIntersection.h"
+
+namespace SpatialiteDatasource {
+
+void BufferedFeature::AddTo(IFeature& feature) const
+{
+    for (const auto& [name, value] : m_attributes)
+    {
+        std::visit([&feature, &name](const auto& v) { feature.AddAttribute(name, v); }, value);
+    }
+    for (const auto& [type, points] : m_geometries)
+    {
+        auto& geometry = feature.AddGeometry(type, points.size());
+        for (const auto& point : points)
+        {
+            geometry.AddPoint(point);
+        }
+    }
+}
+
+[[nodiscard]] std::optional<Mbr> BufferedFeature::GetMbr() const noexcept
+{
+    std::optional<Mbr> mbr;
+    for (const auto& geometry : m_geometries)
+    {
+        for (const auto& point : geometry.points)
+        {
+            const Mbr pointMbr{point.x, point.y, point.x, point.y};
+            mbr = mbr.has_value() ? Union(*mbr, pointMbr) : pointMbr;
+        }
+    }
+    return mbr;
+}
+
+[[nodiscard]] size_t BufferedFeature::GetPointsCount() const noexcept
+{
+    size_t count = 0;
+    for (const auto& geometry : m_geometries)
+    {
+        count += geometry.points.size();
+    }
+    return count;
+}
+
+[[nodiscard]] bool BufferedFeature::Intersects(const Mbr& mbr) const noexcept
+{
+    for (const auto& [type, points] : m_geometries)
+    {
+        bool intersects = false;
+        switch (type)
+        {
+        case GeometryType::Point:
+        case GeometryType::MultiPoint:
+            intersects = PointsIntersect(points, mbr);
+            break;
+        case GeometryType::Line:
+        case GeometryType::MultiLine:
+            intersects = LineIntersects(points, mbr);
+            break;
+        case GeometryType::Polygon:
+        case GeometryType::MultiPolygon:
+            intersects = PolygonIntersects(points, mbr);
+            break;
+        }
+        if (intersects)
+            return true;
+    }
+    return false;
+}
+
+IGeometry& BufferedFeature::AddGeometry(GeometryType type, size_t initialCapacity)
+{
+    auto& geometry = m_geometries.emplace_back(type);
+    geometry.points.reserve(initialCapacity);
+    // adding another geometry may reallocate the storage, but the handle is only valid until then
+    m_geometry.m_points = &geometry.points;
+    return m_geometry;
+}
+
+[[nodiscard]] std::optional<double> BufferedFeature::GetNumericAttribute(std::string_view name) const noexcept
+{
+    for (const auto& [attributeName, value] : m_attributes)
+    {
+        if (attributeName != name)
+            continue;
+        if (const auto* intValue = std::get_if<int64_t>(&value))
+            return static_cast<double>(*intValue);
+        if (const auto* doubleValue = std::get_if<double>(&value))
+            return *doubleValue;
+        return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+void BufferedFeature::AddAttribute(std::string_view name, int64_t value)
+{
+    m_attributes.emplace_back(name, value);
+}
+
+void BufferedFeature::AddAttribute(std::string_view name, double value)
+{
+    m_attributes.emplace_back(name, value);
+}
+
+void BufferedFeature::AddAttribute(std::string_view name, std::string_view value)
+{
+    m_attributes.emplace_back(name, std::string{value});
+}
+
+} // namespace SpatialiteDatasource
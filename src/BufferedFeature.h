@@ -0,0 +1,142 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "IFeature.h"
+#include "Mbr.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Feature that keeps decoded geometries and attributes in memory,
+ *  so they can be added to one or more other features later
+ */
+class BufferedFeature : public IFeature
+{
+public:
+    explicit BufferedFeature(int id) noexcept : m_id{id} {}
+
+    /**
+     * @brief Get the id of the feature (primary key)
+     */
+    [[nodiscard]] int GetId() const noexcept { return m_id; }
+
+    /**
+     * @brief Get the MBR of all buffered geometries
+     * 
+     * @return MBR or std::nullopt if the feature has no points
+     */
+    [[nodiscard]] std::optional<Mbr> GetMbr() const noexcept;
+
+    /**
+     * @brief Get the number of points of all buffered geometries
+     */
+    [[nodiscard]] size_t GetPointsCount() const noexcept;
+
+    /**
+     * @brief Check whether any of the buffered geometries intersects the MBR, using the decoded coordinates
+     *  instead of the MBR of the feature
+     */
+    [[nodiscard]] bool Intersects(const Mbr& mbr) const noexcept;
+
+    /**
+     * @brief Get the value of a numeric attribute
+     * 
+     * @return Value or std::nullopt if the feature has no such attribute or it's a string
+     */
+    [[nodiscard]] std::optional<double> GetNumericAttribute(std::string_view name) const noexcept;
+
+    /**
+     * @brief Call the function with every buffered point
+     */
+    template <class Function>
+    void ForEachPoint(Function&& function) const
+    {
+        for (const auto& geometry : m_geometries)
+        {
+            for (const auto& point : geometry.points)
+            {
+                function(point);
+            }
+        }
+    }
+
+    /**
+     * @brief Add the buffered geometries and attributes to the given feature
+     */
+    void AddTo(IFeature& feature) const;
+
+    IGeometry& AddGeometry(GeometryType type, size_t initialCapacity) final;
+
+    void AddAttribute(std::string_view name, int64_t value) final;
+    void AddAttribute(std::string_view name, double value) final;
+    void AddAttribute(std::string_view name, std::string_view value) final;
+
+private:
+    struct GeometryData
+    {
+        GeometryType type;
+        std::vector<mapget::Point> points;
+    };
+
+    /**
+     * @brief Geometry that appends points to the last geometry of the feature
+     */
+    class Geometry : public IGeometry
+    {
+    public:
+        void AddPoint(const mapget::Point& point) final { m_points->push_back(point); }
+
+    private:
+        friend class BufferedFeature;
+        std::vector<mapget::Point>* m_points = nullptr;
+    };
+
+    using AttributeValue = std::variant<int64_t, double, std::string>;
+
+    int m_id;
+    std::vector<GeometryData> m_geometries;
+    std::vector<std::pair<std::string, AttributeValue>> m_attributes;
+    Geometry m_geometry; /// Handle of the last added geometry
+};
+
+using BufferedFeatures = std::vector<BufferedFeature>;
+
+/**
+ * @brief Features of a single tile. The buffer may be shared by several tiles
+ *  if they were read with a single query
+ */
+struct TileFeatures
+{
+    std::shared_ptr<const BufferedFeatures> buffer;
+    std::vector<const BufferedFeature*> features; /// Features from the buffer within the tile
+};
+
+} // namespace SpatialiteDatasource
@@ -21,16 +21,65 @@
 #include "ConfigLoader.h"
 
 #include "ConfigSchema.h"
+#include "QueryPlanAudit.h"
 
 #include <cerberus-cpp/validator.hh>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <ranges>
 #include <sstream>
+#include <thread>
 
 namespace SpatialiteDatasource {
+
+/**
+ * @brief Column which type is used for an attribute
+ */
+struct ColumnRef
+{
+    std::string table;
+    std::string column;
+};
+
+/**
+ * @brief Everything needed to load the table info, collected from the config before querying the database
+ */
+struct TableIntrospection
+{
+    TableMetadata metadata;
+    ScalingInfo scaling;
+    bool loadAttributesFromDb = false;
+    AttributesInfo configuredAttributes;
+    std::vector<std::pair<std::string /* attribute */, ColumnRef>> attributeTypeColumns;
+};
+
 namespace {
 
+[[nodiscard]] TableInfo LoadTableInfo(const std::string& tableName, const TableIntrospection& introspection, const Database& db)
+{
+    TableInfo tableInfo{tableName, db, introspection.metadata};
+    tableInfo.scaling = introspection.scaling;
+    if (introspection.loadAttributesFromDb)
+    {
+        db.FillTableAttributes(tableInfo);
+    }
+    for (const auto& [attribute, attributeInfo] : introspection.configuredAttributes)
+    {
+        tableInfo.attributes[attribute] = attributeInfo;
+    }
+    for (const auto& [attribute, column] : introspection.attributeTypeColumns)
+    {
+        tableInfo.attributes[attribute].type = db.GetColumnType(column.table, column.column);
+    }
+    return tableInfo;
+}
+
 template <class Head, class... Tail>
 [[nodiscard]] YAML::Node GetNode(const YAML::Node& node, const Head& headPath, const Tail&... tailPath)
 {
@@ -59,11 +108,43 @@ template <class T, class String>
     return defaultValue;
 }
 
-TableInfo& EmplaceTableInfo(TablesInfo& tablesInfo, const std::string& tableName, const Database& database)
+void RunOnPool(std::vector<std::function<void(const Database&)>>& tasks, DatabasePool& pool)
 {
-    const auto emplaceResult = tablesInfo.emplace(
-            std::piecewise_construct, std::forward_as_tuple(tableName), std::forward_as_tuple(tableName, database));
-    return emplaceResult.first->second;
+    std::atomic<size_t> next = 0;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    const auto work = [&]
+    {
+        const auto connection = pool.Acquire();
+        for (auto i = next++; i < tasks.size(); i = next++)
+        {
+            try
+            {
+                tasks[i](*connection);
+            }
+            catch (...)
+            {
+                std::lock_guard lock{errorMutex};
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    for (size_t i = 1; i < std::min(pool.Size(), tasks.size()); ++i)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    workers.clear();
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
 }
 
 [[nodiscard]] ScalingInfo ParseScalingConfig(const YAML::Node& config, ScalingInfo defaultScaling = {})
@@ -94,7 +175,13 @@ TableInfo& EmplaceTableInfo(TablesInfo& tablesInfo, const std::string& tableName
     return result;
 }
 
-[[nodiscard]] AttributeInfo ParseAttributeInfo(const YAML::Node& attributeDescription, const Database& database)
+/**
+ * @brief Parse the attribute config
+ * 
+ * @param attributeDescription Attribute config
+ * @param typeColumn Set to the column which type must be used if the type is neither configured nor implied
+ */
+[[nodiscard]] AttributeInfo ParseAttributeInfo(const YAML::Node& attributeDescription, std::optional<ColumnRef>& typeColumn)
 {
     AttributeInfo attribute;
     std::optional<ColumnType> type;
@@ -115,7 +202,9 @@ TableInfo& EmplaceTableInfo(TablesInfo& tablesInfo, const std::string& tableName
             auto tableName = columnName.substr(0, columnName.find('.'));
             if (!type.has_value())
             {
-                type = database.GetColumnType(tableName, columnName);
+                // Resolved by a database query later
+                type = ColumnType::Blob;
+                typeColumn = ColumnRef{std::move(tableName), columnName};
             }
             relation.columns.emplace_back(std::move(columnName));
         }
@@ -135,6 +224,59 @@ TableInfo& EmplaceTableInfo(TablesInfo& tablesInfo, const std::string& tableName
     return attribute;
 }
 
+void ParseLayerOptions(const YAML::Node& config, LayerOptions& options)
+{
+    if (const auto culling = config["subPixelCulling"]; culling)
+    {
+        options.subPixelCullingPixels = GetValueOrDefault(culling, "minPixels", 1.);
+        if (options.subPixelCullingPixels < 0.)
+        {
+            throw std::runtime_error{"Invalid 'subPixelCulling' config: 'minPixels' must not be negative"};
+        }
+    }
+    options.exactIntersection = GetValueOrDefault(config, "exactIntersection", options.exactIntersection);
+    if (const auto precision = config["precision"]; precision)
+    {
+        // the keys missing in the layer config are taken from the global one
+        options.quantizationGridPixels = GetValueOrDefault(precision, "gridPixels", options.quantizationGridPixels);
+        options.quantizationMaxZoom = GetValueOrDefault(precision, "maxZoom", options.quantizationMaxZoom);
+        options.dropZBelowZoom = GetValueOrDefault(precision, "dropZBelowZoom", options.dropZBelowZoom);
+        if (options.quantizationGridPixels < 0.)
+        {
+            throw std::runtime_error{"Invalid 'precision' config: 'gridPixels' must not be negative"};
+        }
+    }
+    if (const auto clustering = config["clustering"]; clustering)
+    {
+        options.clusterBelowZoom = GetValueOrDefault(clustering, "belowZoom", options.clusterBelowZoom);
+        options.clusterCellPixels = GetValueOrDefault(clustering, "cellPixels", options.clusterCellPixels);
+        if (options.clusterCellPixels <= 0.)
+        {
+            throw std::runtime_error{"Invalid 'clustering' config: 'cellPixels' must be positive"};
+        }
+    }
+    if (const auto budget = config["budget"]; budget)
+    {
+        options.maxFeatures = GetValueOrDefault(budget, "maxFeatures", options.maxFeatures);
+        options.maxVertices = GetValueOrDefault(budget, "maxVertices", options.maxVertices);
+        const auto importance = budget["importance"];
+        if (importance)
+        {
+            options.importance = importance.as<std::string>() == "order" ? FeatureImportance::Order : FeatureImportance::Size;
+        }
+        if (const auto attribute = budget["attribute"]; attribute)
+        {
+            if (importance && options.importance == FeatureImportance::Order)
+            {
+                throw std::runtime_error{"Invalid 'budget' config: 'attribute' can't be used with the 'order' importance"};
+            }
+            options.importance = FeatureImportance::Attribute;
+            options.importanceAttribute = attribute.as<std::string>();
+        }
+        options.importanceAscending = GetValueOrDefault(budget, "ascending", options.importanceAscending);
+    }
+}
+
 void LogTablesInfo(const TablesInfo& info)
 {
     std::string log = "Loaded attributes config:";
@@ -173,6 +315,7 @@ void LogTablesInfo(const TablesInfo& info)
 ConfigLoader::ConfigLoader(const YAML::Node& config, const OverrideOptions& options)
     : m_config{config}
     , m_loadRemainingLayersFromDb{GetValueOrDefault(m_config, "loadRemainingLayersFromDb", true)}
+    , m_lazyLayers{GetValueOrDefault(m_config, "lazyLayers", false)}
 {
     cerberus::Validator validator{YAML::Load(ConfigSchema)};
     if (!validator.validate(m_config))
@@ -215,6 +358,88 @@ ConfigLoader::ConfigLoader(const YAML::Node& config, const OverrideOptions& opti
     m_datasourceOptions.port = loadOverrideOption("datasourcePort", options.port, static_cast<uint16_t>(0));
     m_disableAttributes = loadOverrideOption("disableAttributes", options.disableAttributes, false);
 
+    if (const auto tileBatching = m_config["tileBatching"]; tileBatching)
+    {
+        m_tileBatchingOptions.window = std::chrono::milliseconds{GetValueOrDefault(tileBatching, "windowMs", 0)};
+        m_tileBatchingOptions.maxTiles = GetValueOrDefault<size_t>(tileBatching, "maxTiles", 16);
+        if (m_tileBatchingOptions.window.count() < 0 || m_tileBatchingOptions.maxTiles == 0)
+        {
+            throw std::runtime_error{"Invalid 'tileBatching' config: 'windowMs' must not be negative, 'maxTiles' must be positive"};
+        }
+    }
+
+    if (const auto decodePipeline = m_config["decodePipeline"]; decodePipeline)
+    {
+        m_decodePipelineOptions.threads = GetValueOrDefault<size_t>(decodePipeline, "threads", 0);
+        m_decodePipelineOptions.batchSize = GetValueOrDefault<size_t>(decodePipeline, "batchSize", 256);
+        if (m_decodePipelineOptions.batchSize == 0)
+        {
+            throw std::runtime_error{"Invalid 'decodePipeline' config: 'batchSize' must be positive"};
+        }
+    }
+
+    if (const auto databasePool = m_config["databasePool"]; databasePool)
+    {
+        m_databasePoolOptions.connections = GetValueOrDefault<size_t>(databasePool, "connections", 0);
+    }
+
+    if (const auto heavyTiles = m_config["heavyTiles"]; heavyTiles)
+    {
+        m_heavyTileOptions.minFeatures = GetValueOrDefault<size_t>(heavyTiles, "minFeatures", 0);
+        m_heavyTileOptions.splitGrid = GetValueOrDefault<size_t>(heavyTiles, "splitGrid", 2);
+        if (m_heavyTileOptions.splitGrid < 2)
+        {
+            throw std::runtime_error{"Invalid 'heavyTiles' config: 'splitGrid' must be at least 2"};
+        }
+    }
+
+    if (const auto metrics = m_config["metrics"]; metrics)
+    {
+        m_metricsOptions.host = GetValueOrDefault(metrics, "host", m_metricsOptions.host);
+        m_metricsOptions.port = GetValueOrDefault<uint16_t>(metrics, "port", 0);
+    }
+
+    if (const auto queryPlanAudit = m_config["queryPlanAudit"]; queryPlanAudit)
+    {
+        const auto onFullScan = GetValueOrDefault<std::string>(queryPlanAudit, "onFullScan", "warn");
+        m_queryPlanAuditOptions.onFullScan = onFullScan == "ignore" 
+            ? FullScanPolicy::Ignore 
+            : onFullScan == "fail" ? FullScanPolicy::Fail : FullScanPolicy::Warn;
+    }
+
+    if (const auto slowQueries = m_config["slowQueries"]; slowQueries)
+    {
+        m_slowQueryLogOptions.threshold = std::chrono::milliseconds{GetValueOrDefault(slowQueries, "thresholdMs", 0)};
+        m_slowQueryLogOptions.capacity = GetValueOrDefault<size_t>(slowQueries, "capacity", 64);
+    }
+
+    if (const auto tracing = m_config["tracing"]; tracing)
+    {
+        m_tracingOptions.path = tracing["path"].as<std::string>();
+        m_tracingOptions.format = GetValueOrDefault<std::string>(tracing, "format", "chrome") == "jsonl"
+            ? TraceFormat::JsonLines
+            : TraceFormat::Chrome;
+        m_tracingOptions.sampleRate = GetValueOrDefault(tracing, "sampleRate", 0.01);
+        if (m_tracingOptions.sampleRate < 0. || m_tracingOptions.sampleRate > 1.)
+        {
+            throw std::runtime_error{"Invalid 'tracing' config: 'sampleRate' must be within [0, 1]"};
+        }
+    }
+
+    if (const auto tileDeadline = m_config["tileDeadline"]; tileDeadline)
+    {
+        m_tileDeadlineOptions.timeout = std::chrono::milliseconds{tileDeadline["timeoutMs"].as<int>()};
+        if (m_tileDeadlineOptions.timeout.count() < 0)
+        {
+            throw std::runtime_error{"Invalid 'tileDeadline' config: 'timeoutMs' must not be negative"};
+        }
+    }
+
+    if (const auto pyramid = m_config["pyramid"]; pyramid)
+    {
+        m_pyramidOptions.path = pyramid["path"].as<std::string>();
+    }
+
     if (const auto layers = m_config["layers"]; layers)
     {
         for (const auto& layer : layers)
@@ -222,6 +447,42 @@ ConfigLoader::ConfigLoader(const YAML::Node& config, const OverrideOptions& opti
             const auto tableName = boost::to_lower_copy(layer["table"].as<std::string>());
             m_layerConfigByTable.emplace(tableName, layer);
         }
+        for (const auto& [tableName, layer] : m_layerConfigByTable)
+        {
+            for (const auto& source : layer["zoomSources"])
+            {
+                auto sourceTable = boost::to_lower_copy(source["table"].as<std::string>());
+                if (m_layerConfigByTable.contains(sourceTable))
+                {
+                    throw std::runtime_error{fmt::format(
+                        "Invalid 'zoomSources' config: table '{}' is a layer itself", sourceTable)};
+                }
+                // the features of a source are located in the layer, so their ids must be the layer ones
+                const auto key = source["key"];
+                if (!key)
+                {
+                    throw std::runtime_error{fmt::format(
+                        "Invalid 'zoomSources' config: table '{}' has no 'key' column of the layer ids", sourceTable)};
+                }
+                if (!m_sourceTables.emplace(std::move(sourceTable), ZoomSourceTable{tableName, key.as<std::string>()}).second)
+                {
+                    throw std::runtime_error{fmt::format(
+                        "Invalid 'zoomSources' config: table '{}' is a source of several layers", source["table"].as<std::string>())};
+                }
+            }
+        }
+    }
+
+    if (const auto cachePath = GetNode(m_config, "schemaCache", "path"); cachePath)
+    {
+        m_schemaCachePath = cachePath.as<std::string>();
+        m_schemaFingerprint = GetSchemaFingerprint();
+        m_schemaSnapshot = LoadSchemaSnapshot(*m_schemaCachePath, m_schemaFingerprint);
+        if (m_schemaSnapshot.has_value())
+        {
+            mapget::log().info("Schema of {} tables is loaded from the cache '{}'", 
+                m_schemaSnapshot->tablesInfo.size(), m_schemaCachePath->string());
+        }
     }
 }
 
@@ -230,8 +491,91 @@ ConfigLoader::ConfigLoader(const YAML::Node& config, const OverrideOptions& opti
     return m_datasourceOptions;
 }
 
+[[nodiscard]] const TileBatchingOptions& ConfigLoader::GetTileBatchingOptions() const
+{
+    return m_tileBatchingOptions;
+}
+
+[[nodiscard]] const DecodePipelineOptions& ConfigLoader::GetDecodePipelineOptions() const
+{
+    return m_decodePipelineOptions;
+}
+
+[[nodiscard]] const DatabasePoolOptions& ConfigLoader::GetDatabasePoolOptions() const
+{
+    return m_databasePoolOptions;
+}
+
+[[nodiscard]] const HeavyTileOptions& ConfigLoader::GetHeavyTileOptions() const
+{
+    return m_heavyTileOptions;
+}
+
+[[nodiscard]] const MetricsOptions& ConfigLoader::GetMetricsOptions() const
+{
+    return m_metricsOptions;
+}
+
+[[nodiscard]] const QueryPlanAuditOptions& ConfigLoader::GetQueryPlanAuditOptions() const
+{
+    return m_queryPlanAuditOptions;
+}
+
+[[nodiscard]] const SlowQueryLogOptions& ConfigLoader::GetSlowQueryLogOptions() const
+{
+    return m_slowQueryLogOptions;
+}
+
+[[nodiscard]] const TracingOptions& ConfigLoader::GetTracingOptions() const
+{
+    return m_tracingOptions;
+}
+
+[[nodiscard]] const PyramidOptions& ConfigLoader::GetPyramidOptions() const
+{
+    return m_pyramidOptions;
+}
+
+[[nodiscard]] const TileDeadlineOptions& ConfigLoader::GetTileDeadlineOptions() const
+{
+    return m_tileDeadlineOptions;
+}
+
+[[nodiscard]] LayerOptions ConfigLoader::GetLayerOptions(const std::string& table) const
+{
+    LayerOptions options;
+    if (const auto global = m_config["global"]; global)
+    {
+        ParseLayerOptions(global, options);
+    }
+
+    auto layerTable = boost::to_lower_copy(table);
+    if (const auto sourceIt = m_sourceTables.find(layerTable); sourceIt != m_sourceTables.end())
+    {
+        layerTable = sourceIt->second.layer;
+    }
+    if (const auto layerIt = m_layerConfigByTable.find(layerTable); layerIt != m_layerConfigByTable.end())
+    {
+        ParseLayerOptions(layerIt->second, options);
+        for (const auto& source : layerIt->second["zoomSources"])
+        {
+            options.zoomSources.push_back({
+                .maxZoom = source["maxZoom"].as<uint16_t>(),
+                .table = boost::to_lower_copy(source["table"].as<std::string>())
+            });
+        }
+        std::ranges::sort(options.zoomSources, {}, &ZoomSource::maxZoom);
+    }
+    return options;
+}
+
 [[nodiscard]] nlohmann::json ConfigLoader::GenerateDatasourceConfig(const Database& database) const
 {
+    if (m_schemaSnapshot.has_value())
+    {
+        return m_schemaSnapshot->datasourceConfig;
+    }
+
     nlohmann::json infoJson;
     const auto mapIdNode = GetNode(m_config, "map", "name");
     infoJson["mapId"] = mapIdNode ? mapIdNode.as<std::string>() : m_datasourceOptions.mapPath.filename().string();
@@ -254,11 +598,12 @@ ConfigLoader::ConfigLoader(const YAML::Node& config, const OverrideOptions& opti
 
     if (m_loadRemainingLayersFromDb)
     {
-        const auto tables = database.GetTablesNames();
-        for (const auto& table : tables)
+        for (const auto& table : GetTablesMetadata(database))
         {
-            if (!m_layerConfigByTable.contains(boost::to_lower_copy(table)))
-                addLayer(table, table);
+            // zoom sources are presented by their layer
+            const auto tableName = boost::to_lower_copy(table.tableName);
+            if (!m_layerConfigByTable.contains(tableName) && !m_sourceTables.contains(tableName))
+                addLayer(table.tableName, table.tableName);
         }
     }
     
@@ -268,7 +613,110 @@ ConfigLoader::ConfigLoader(const YAML::Node& config, const OverrideOptions& opti
 
 [[nodiscard]] TablesInfo ConfigLoader::LoadTablesInfo(const Database& database) const
 {
+    return LoadTablesInfo(database, [&database](IntrospectionTasks& tasks) {
+        for (auto& task : tasks)
+        {
+            task(database);
+        }
+    });
+}
+
+[[nodiscard]] TablesInfo ConfigLoader::LoadTablesInfo(const Database& database, DatabasePool& pool) const
+{
+    return LoadTablesInfo(database, [&pool](IntrospectionTasks& tasks) { RunOnPool(tasks, pool); });
+}
+
+[[nodiscard]] TablesInfo ConfigLoader::LoadTablesInfo(const Database& database, const RunIntrospection& run) const
+{
+    if (m_schemaSnapshot.has_value())
+    {
+        return m_schemaSnapshot->tablesInfo;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto toMs = [](Clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    };
+    const auto start = Clock::now();
+    const auto introspections = PlanIntrospection(database);
+    const auto metadataLoaded = Clock::now();
+
+    // Slots are created before the tasks run, so that each task writes only its own table info
     TablesInfo tablesInfo;
+    IntrospectionTasks tasks;
+    std::vector<std::pair<std::string, Clock::duration>> durations(introspections.size());
+    tasks.reserve(introspections.size());
+    for (const auto& [tableName, introspection] : introspections)
+    {
+        auto& result = tablesInfo[tableName];
+        auto& duration = durations[tasks.size()];
+        tasks.emplace_back([&tableName, &introspection, &result, &duration](const Database& db) {
+            const auto taskStart = Clock::now();
+            result = LoadTableInfo(tableName, introspection, db);
+            duration = {tableName, Clock::now() - taskStart};
+        });
+    }
+    run(tasks);
+
+    const auto slowest = std::ranges::max_element(durations, {}, &decltype(durations)::value_type::second);
+    mapget::log().info("Loaded info of {} tables in {}ms (metadata: {}ms, tables: {}ms{})",
+        tablesInfo.size(), toMs(Clock::now() - start), toMs(metadataLoaded - start), toMs(Clock::now() - metadataLoaded),
+        slowest == durations.end() ? "" : fmt::format(", slowest: '{}' {}ms", slowest->first, toMs(slowest->second)));
+
+    if (mapget::log().level() == spdlog::level::debug)
+    {
+        LogTablesInfo(tablesInfo);
+    }
+
+    if (m_schemaCachePath.has_value())
+    {
+        StoreSchemaSnapshot(*m_schemaCachePath, m_schemaFingerprint, {GenerateDatasourceConfig(database), tablesInfo});
+    }
+
+    return tablesInfo;
+}
+
+[[nodiscard]] LazyTablesInfo ConfigLoader::LoadLazyTablesInfo(const Database& database, DatabasePool& pool) const
+{
+    LazyTablesInfo lazyTablesInfo;
+    // The cached schema is complete, so there is nothing to postpone.
+    // A failed audit must stop the datasource on startup, so the layers can't wait for their first request
+    const auto isAuditFailing = m_queryPlanAuditOptions.onFullScan == FullScanPolicy::Fail;
+    if (m_lazyLayers && isAuditFailing && !m_schemaSnapshot.has_value())
+    {
+        mapget::log().info("Lazy layers are loaded on startup, since the query plan audit fails on full scans");
+    }
+    if (!m_lazyLayers || m_schemaSnapshot.has_value() || isAuditFailing)
+    {
+        for (auto& [tableName, tableInfo] : LoadTablesInfo(database, pool))
+        {
+            lazyTablesInfo.emplace(
+                std::piecewise_construct, std::forward_as_tuple(tableName), std::forward_as_tuple(std::move(tableInfo)));
+        }
+        return lazyTablesInfo;
+    }
+
+    for (auto& [tableName, introspection] : PlanIntrospection(database))
+    {
+        lazyTablesInfo.emplace(std::piecewise_construct, std::forward_as_tuple(tableName), std::forward_as_tuple(
+            [tableName, introspection = std::move(introspection), auditOptions = m_queryPlanAuditOptions](const Database& db) {
+                auto tableInfo = LoadTableInfo(tableName, introspection, db);
+                AuditQueryPlans(db, {&tableInfo}, auditOptions);
+                return tableInfo;
+            }));
+    }
+    mapget::log().info("Info of {} tables will be loaded on the first request", lazyTablesInfo.size());
+    return lazyTablesInfo;
+}
+
+[[nodiscard]] std::unordered_map<std::string, TableIntrospection> ConfigLoader::PlanIntrospection(const Database& database) const
+{
+    std::unordered_map<std::string, const TableMetadata*> metadataByTable;
+    for (const auto& metadata : GetTablesMetadata(database))
+    {
+        metadataByTable.emplace(boost::to_lower_copy(metadata.tableName), &metadata);
+    }
+
     ScalingInfo defaultScaling{};
     const auto globalScaling = GetNode(m_config, "global", "coordinatesScaling");
     if (globalScaling)
@@ -276,57 +724,96 @@ ConfigLoader::ConfigLoader(const YAML::Node& config, const OverrideOptions& opti
         defaultScaling = ParseScalingConfig(globalScaling);
     }
 
+    // The config is parsed upfront, so that only database queries run concurrently or later
+    std::unordered_map<std::string, TableIntrospection> introspections;
+    const auto addIntrospection = [&](const std::string& tableName) -> TableIntrospection&
+    {
+        const auto metadataIt = metadataByTable.find(tableName);
+        if (metadataIt == metadataByTable.end())
+        {
+            throw std::runtime_error{fmt::format("Table '{}' is not in 'geometry_columns'", tableName)};
+        }
+        auto& introspection = introspections[tableName];
+        introspection.metadata = *metadataIt->second;
+        introspection.scaling = defaultScaling;
+        return introspection;
+    };
+
     for (const auto& [tableName, layer] : m_layerConfigByTable)
     {
-        auto& tableInfo = EmplaceTableInfo(tablesInfo, tableName, database);
+        auto& introspection = addIntrospection(tableName);
 
         if (const auto scalingConfig = layer["coordinatesScaling"]; scalingConfig)
         {
-            tableInfo.scaling = ParseScalingConfig(scalingConfig, defaultScaling);            
-        }
-        else
-        {
-            tableInfo.scaling = defaultScaling;
+            introspection.scaling = ParseScalingConfig(scalingConfig, defaultScaling);            
         }
         
         if (!m_disableAttributes)
         {
-            if (GetValueOrDefault(layer, "loadRemainingAttributesFromDb", true))
-            {
-                database.FillTableAttributes(tableInfo);
-            }
+            introspection.loadAttributesFromDb = GetValueOrDefault(layer, "loadRemainingAttributesFromDb", true);
 
             if (const auto& attributes = layer["attributes"]; attributes)
             {
                 for (const auto attribute : attributes)
                 {
-                    tableInfo.attributes[attribute["name"].as<std::string>()] = ParseAttributeInfo(attribute, database);
+                    auto name = attribute["name"].as<std::string>();
+                    std::optional<ColumnRef> typeColumn;
+                    introspection.configuredAttributes[name] = ParseAttributeInfo(attribute, typeColumn);
+                    if (typeColumn.has_value())
+                    {
+                        introspection.attributeTypeColumns.emplace_back(std::move(name), std::move(*typeColumn));
+                    }
                 }
             }
         }
     }
 
+    // zoom sources are read as their layer, so they get the same attributes and scaling,
+    // and their ids are taken from the key column of the layer ids instead of their own primary key
+    for (const auto& [sourceTable, source] : m_sourceTables)
+    {
+        auto introspection = introspections.at(source.layer);
+        auto& sourceIntrospection = addIntrospection(sourceTable);
+        introspection.metadata = sourceIntrospection.metadata;
+        introspection.metadata.primaryKey = source.key;
+        sourceIntrospection = std::move(introspection);
+    }
+
     if (m_loadRemainingLayersFromDb)
     {
-        auto tableNames = database.GetTablesNames();
-        for (auto& tableName : tableNames)
+        for (const auto& tableName : std::views::keys(metadataByTable))
         {
-            boost::to_lower(tableName);
-            if (tablesInfo.contains(tableName))
+            if (introspections.contains(tableName))
                 continue;
 
-            auto& tableInfo = EmplaceTableInfo(tablesInfo, tableName, database);
-            tableInfo.scaling = defaultScaling;
-            database.FillTableAttributes(tableInfo);
+            addIntrospection(tableName).loadAttributesFromDb = true;
         }
     }
 
-    if (mapget::log().level() == spdlog::level::debug)
+    return introspections;
+}
+
+[[nodiscard]] std::string ConfigLoader::GetSchemaFingerprint() const
+{
+    std::string schemaConfig;
+    for (const auto* key : {"map", "loadRemainingLayersFromDb", "global", "layers"})
     {
-        LogTablesInfo(tablesInfo);
+        if (const auto node = m_config[key]; node)
+        {
+            schemaConfig += fmt::format("{}: {}\n", key, YAML::Dump(node));
+        }
     }
+    return fmt::format("{}|{}|{:016x}", 
+        GetDatabaseIdentity(m_datasourceOptions.mapPath), m_disableAttributes, GetStableHash(schemaConfig));
+}
 
-    return tablesInfo;
+[[nodiscard]] const std::vector<TableMetadata>& ConfigLoader::GetTablesMetadata(const Database& database) const
+{
+    if (!m_tablesMetadata.has_value())
+    {
+        m_tablesMetadata = database.GetTablesMetadata();
+    }
+    return *m_tablesMetadata;
 }
 
 } // namespace SpatialiteDatasource
\ No newline at end of file
@@ -21,18 +21,28 @@
 #pragma once
 
 #include "Database.h"
+#include "DatabasePool.h"
+#include "LazyTableInfo.h"
+#include "SchemaCache.h"
 
 #include "TableInfo.h"
 
 #include <nlohmann/json.hpp>
 #include <yaml-cpp/yaml.h>
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <limits>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace SpatialiteDatasource {
 
+struct TableIntrospection;
+
 /**
  * @brief Used for options that can be overriden by command line options
  */
@@ -52,6 +62,142 @@ struct DatasourceOptions
     uint16_t port;
 };
 
+/**
+ * @brief Options for batching tile requests of the same layer into a single query
+ */
+struct TileBatchingOptions
+{
+    std::chrono::milliseconds window{0}; /// Time to collect requests for a batch, batching is disabled if 0
+    size_t maxTiles = 16;                /// Maximum number of tiles (and size of the batch MBR in tiles)
+};
+
+/**
+ * @brief Options for decoding geometries of a tile in parallel with reading them from the db
+ */
+struct DecodePipelineOptions
+{
+    size_t threads = 0;     /// Number of decode threads, the pipeline is disabled if 0
+    size_t batchSize = 256; /// Number of rows passed to a decode thread at once
+};
+
+/**
+ * @brief Options for the pool of database connections used by tile requests
+ */
+struct DatabasePoolOptions
+{
+    size_t connections = 0; /// Number of connections, the number of CPU cores if 0
+};
+
+/**
+ * @brief Options for splitting tiles with many features into parts that are read concurrently
+ */
+struct HeavyTileOptions
+{
+    size_t minFeatures = 0; /// Expected number of features from which a tile is split, splitting is disabled if 0
+    size_t splitGrid = 2;   /// Number of parts along each axis of the tile
+};
+
+/**
+ * @brief Options of the admin metrics endpoint
+ */
+struct MetricsOptions
+{
+    std::string host = "127.0.0.1"; /// Address the endpoint is bound to, only local by default
+    uint16_t port = 0;              /// Port of the '/metrics' endpoint, disabled if 0
+};
+
+enum class FullScanPolicy
+{
+    Ignore, /// The query plans are not audited
+    Warn,
+    Fail
+};
+
+/**
+ * @brief Options of auditing the query plans of the layers on startup
+ */
+struct QueryPlanAuditOptions
+{
+    FullScanPolicy onFullScan = FullScanPolicy::Warn;
+};
+
+/**
+ * @brief Options of the slow tile query log
+ */
+struct SlowQueryLogOptions
+{
+    std::chrono::milliseconds threshold{0}; /// Queries taking at least this long are recorded, disabled if 0
+    size_t capacity = 64;                   /// Number of the latest slow queries to keep
+};
+
+enum class TraceFormat
+{
+    Chrome, /// Chrome trace event format
+    JsonLines
+};
+
+/**
+ * @brief Options of tracing sampled tile requests
+ */
+struct TracingOptions
+{
+    std::filesystem::path path; /// Trace file, tracing is disabled if empty
+    TraceFormat format = TraceFormat::Chrome;
+    double sampleRate = 0.01;   /// Share of traced tile requests
+};
+
+/**
+ * @brief Options of the tile request deadline
+ */
+struct TileDeadlineOptions
+{
+    std::chrono::milliseconds timeout{0}; /// Queries of a tile request are interrupted after this long, disabled if 0
+};
+
+/**
+ * @brief Options of the sidecar database with simplified copies of the layer tables
+ */
+struct PyramidOptions
+{
+    std::filesystem::path path; /// Pyramid database, disabled if empty
+};
+
+/**
+ * @brief Pre-generalized copy of a layer table, read instead of it for the tiles of low zoom levels
+ */
+struct ZoomSource
+{
+    uint16_t maxZoom = 0; /// Last zoom level the table is read for
+    std::string table;
+};
+
+enum class FeatureImportance
+{
+    Size,      /// Area of the MBR for polygons, its diagonal for lines and points
+    Attribute, /// Value of a numeric attribute
+    Order      /// Order of the query, the read of a tile stops at the budget
+};
+
+/**
+ * @brief Per-layer options of the features sent for a tile, 'global' sets the defaults of all layers
+ */
+struct LayerOptions
+{
+    double subPixelCullingPixels = 0.; /// Lines and polygons smaller than this many pixels are dropped, disabled if 0
+    bool exactIntersection = false;    /// Drop features which MBR intersects the tile, but the geometry doesn't
+    double quantizationGridPixels = 0.; /// Coordinates are rounded to a grid of this many pixels, disabled if 0
+    uint16_t quantizationMaxZoom = std::numeric_limits<uint16_t>::max(); /// Last zoom level with the quantization
+    uint16_t dropZBelowZoom = 0;       /// Z isn't sent for the tiles of lower zoom levels
+    uint16_t clusterBelowZoom = 0;     /// Points are sent as clusters for the tiles of lower zoom levels
+    double clusterCellPixels = 64.;    /// Size of a cluster cell in pixels
+    std::vector<ZoomSource> zoomSources; /// Sorted by the zoom level, only configured per layer
+    size_t maxFeatures = 0;            /// Features of a tile above the budget are dropped, unlimited if 0
+    size_t maxVertices = 0;            /// Vertices of a tile above the budget are dropped, unlimited if 0
+    FeatureImportance importance = FeatureImportance::Size; /// The least important features are dropped first
+    std::string importanceAttribute;   /// Attribute of FeatureImportance::Attribute
+    bool importanceAscending = false;  /// Lower attribute values are more important
+};
+
 /**
  * @brief Represents datasource config
  */
@@ -72,7 +218,65 @@ public:
     [[nodiscard]] const DatasourceOptions& GetDatasourceOptions() const;
 
     /**
-     * @brief Generate mapget datasource config
+     * @brief Get the tile requests batching options
+     */
+    [[nodiscard]] const TileBatchingOptions& GetTileBatchingOptions() const;
+
+    /**
+     * @brief Get the geometries decode pipeline options
+     */
+    [[nodiscard]] const DecodePipelineOptions& GetDecodePipelineOptions() const;
+
+    /**
+     * @brief Get the database connections pool options
+     */
+    [[nodiscard]] const DatabasePoolOptions& GetDatabasePoolOptions() const;
+
+    /**
+     * @brief Get the heavy tiles splitting options
+     */
+    [[nodiscard]] const HeavyTileOptions& GetHeavyTileOptions() const;
+
+    /**
+     * @brief Get the metrics endpoint options
+     */
+    [[nodiscard]] const MetricsOptions& GetMetricsOptions() const;
+
+    /**
+     * @brief Get the query plan audit options
+     */
+    [[nodiscard]] const QueryPlanAuditOptions& GetQueryPlanAuditOptions() const;
+
+    /**
+     * @brief Get the slow query log options
+     */
+    [[nodiscard]] const SlowQueryLogOptions& GetSlowQueryLogOptions() const;
+
+    /**
+     * @brief Get the tracing options
+     */
+    [[nodiscard]] const TracingOptions& GetTracingOptions() const;
+
+    /**
+     * @brief Get the pyramid database options
+     */
+    [[nodiscard]] const PyramidOptions& GetPyramidOptions() const;
+
+    /**
+     * @brief Get the tile request deadline options
+     */
+    [[nodiscard]] const TileDeadlineOptions& GetTileDeadlineOptions() const;
+
+    /**
+     * @brief Get the options of the layer of the table, the global options if the layer isn't configured.
+     *  Zoom sources share the options of their layer
+     * 
+     * @param table Table name
+     */
+    [[nodiscard]] LayerOptions GetLayerOptions(const std::string& table) const;
+
+    /**
+     * @brief Generate mapget datasource config, it's taken from the schema cache if it's up to date
      * 
      * @param database Spatialite database
      * @return nlohmann::json Mapget datasource config in JSON format
@@ -80,17 +284,77 @@ public:
     [[nodiscard]] nlohmann::json GenerateDatasourceConfig(const Database& database) const;
 
     /**
-     * @brief Load tables info from the config and the database
+     * @brief Load tables info from the config and the database,
+     *  it's taken from the schema cache if it's up to date and stored to the cache otherwise
      * 
      * @param database Spatialite database
      */
     [[nodiscard]] TablesInfo LoadTablesInfo(const Database& database) const;
+
+    /**
+     * @brief Load tables info from the config and the database,
+     *  per table queries run concurrently on the connections of the pool
+     * 
+     * @param database Spatialite database
+     * @param pool Pool of connections to the same database
+     */
+    [[nodiscard]] TablesInfo LoadTablesInfo(const Database& database, DatabasePool& pool) const;
+
+    /**
+     * @brief Load tables info from the config and the database. With 'lazyLayers' enabled 
+     *  only the geometry metadata is read now, the rest is loaded on the first use of a table
+     * 
+     * @param database Spatialite database
+     * @param pool Pool of connections to the same database
+     */
+    [[nodiscard]] LazyTablesInfo LoadLazyTablesInfo(const Database& database, DatabasePool& pool) const;
+private:
+    using IntrospectionTasks = std::vector<std::function<void(const Database&)>>;
+    using RunIntrospection = std::function<void(IntrospectionTasks&)>;
+
+    [[nodiscard]] TablesInfo LoadTablesInfo(const Database& database, const RunIntrospection& run) const;
+
+    /**
+     * @brief Parse the config of every table to load, so that only database queries are left
+     */
+    [[nodiscard]] std::unordered_map<std::string, TableIntrospection> PlanIntrospection(const Database& database) const;
+
+    /**
+     * @brief Get metadata of all tables with a geometry column, it's read from the database only once
+     */
+    [[nodiscard]] const std::vector<TableMetadata>& GetTablesMetadata(const Database& database) const;
+
+    /**
+     * @brief Get the identity of the database and the config options that affect the schema discovery
+     */
+    [[nodiscard]] std::string GetSchemaFingerprint() const;
 private:
     const YAML::Node m_config;
     const bool m_loadRemainingLayersFromDb;
+    const bool m_lazyLayers;
     bool m_disableAttributes;
     DatasourceOptions m_datasourceOptions;
+    TileBatchingOptions m_tileBatchingOptions;
+    DecodePipelineOptions m_decodePipelineOptions;
+    DatabasePoolOptions m_databasePoolOptions;
+    HeavyTileOptions m_heavyTileOptions;
+    MetricsOptions m_metricsOptions;
+    QueryPlanAuditOptions m_queryPlanAuditOptions;
+    SlowQueryLogOptions m_slowQueryLogOptions;
+    TracingOptions m_tracingOptions;
+    PyramidOptions m_pyramidOptions;
+    TileDeadlineOptions m_tileDeadlineOptions;
     std::unordered_map<std::string, YAML::Node> m_layerConfigByTable;
+    struct ZoomSourceTable
+    {
+        std::string layer; /// Layer table
+        std::string key;   /// Column with the ids of the layer features
+    };
+    std::unordered_map<std::string, ZoomSourceTable> m_sourceTables; /// Zoom source table to its layer
+    mutable std::optional<std::vector<TableMetadata>> m_tablesMetadata;
+    std::optional<std::filesystem::path> m_schemaCachePath;
+    std::string m_schemaFingerprint;
+    std::optional<SchemaSnapshot> m_schemaSnapshot; /// Loaded from the cache if it's up to date
 };
 
 } // namespace SpatialiteDatasource
\ No newline at end of file
@@ -19,9 +19,11 @@
 // SOFTWARE.
 
 #include "Database.h"
+#include "Deadline.h"
 #include "TableInfo.h"
 #include "GeometryType.h"
 #include "NavInfoIndex.h"
+#include "Tracing.h"
 
 #include <mapget/log.h>
 #include <sqlite3.h>
@@ -30,15 +32,51 @@
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
+#include <cstdlib>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace SpatialiteDatasource {
 
+namespace {
+
+/// Number of virtual machine instructions between the checks of the request deadline
+constexpr int DeadlineCheckInstructions = 1000;
+
+/**
+ * @brief Progress handler of the connections, a non-zero result interrupts the running statement
+ */
+int InterruptOnDeadline(void*) noexcept
+{
+    const auto* deadline = Deadline::Current();
+    return deadline != nullptr && deadline->IsExpired() ? 1 : 0;
+}
+
+} // namespace
+
+void CheckSrid(const std::string& tableName, int srid)
+{
+    constexpr int Wgs84Srid = 4326;
+    if (srid != Wgs84Srid)
+    {
+        throw std::runtime_error{fmt::format("Geometry column of '{}' table is not in WGS84", tableName)};
+    }
+}
+
 Database::Database(const std::filesystem::path& dbPath)
     : m_db{dbPath}
 {
     m_spatialiteCache = spatialite_alloc_connection();
     spatialite_init_ex(m_db.getHandle(), m_spatialiteCache, 0);
+    sqlite3_progress_handler(m_db.getHandle(), DeadlineCheckInstructions, &InterruptOnDeadline, nullptr);
+}
+
+Database::Database(const std::filesystem::path& dbPath, const std::filesystem::path& attachedDbPath)
+    : Database{dbPath}
+{
+    SQLite::Statement stmt{m_db, fmt::format("ATTACH DATABASE ? AS {};", AttachedSchemaName)};
+    stmt.bind(1, attachedDbPath.string());
+    stmt.exec();
 }
 
 Database::~Database()
@@ -56,21 +94,12 @@ Database::~Database()
     {
         throw std::runtime_error{fmt::format("Table '{}' is not in 'geometry_columns'", tableName)};
     }
-    constexpr int Wgs84Srid = 4326;
-    if (stmt.getColumn(2).getInt() != Wgs84Srid)
-    {
-        throw std::runtime_error{fmt::format("Geometry column of '{}' table is not in WGS84", tableName)};
-    }
+    CheckSrid(tableName, stmt.getColumn(2).getInt());
     return stmt.getColumns<GeometryColumnInfo, 2>();
 }
 
 [[nodiscard]] SpatialIndex Database::GetSpatialIndexType(const std::string& tableName) const
 {
-    if (IsNavInfoIndexAvailable(m_db, tableName))
-    {
-        mapget::log().debug("NavInfo spatial index found for table '{}'", tableName);
-        return SpatialIndex::NavInfo;
-    }
     SQLite::Statement stmt{m_db, R"SQL(
         SELECT spatial_index_enabled FROM geometry_columns WHERE f_table_name = ?;
     )SQL"};
@@ -79,7 +108,17 @@ Database::~Database()
     {
         throw std::runtime_error{fmt::format("Table '{}' is not in 'geometry_columns'", tableName)};
     }
-    switch (stmt.getColumn(0).getInt())
+    return GetSpatialIndexType(tableName, stmt.getColumn(0).getInt());
+}
+
+[[nodiscard]] SpatialIndex Database::GetSpatialIndexType(const std::string& tableName, int spatialIndexEnabled) const
+{
+    if (IsNavInfoIndexAvailable(m_db, tableName))
+    {
+        mapget::log().debug("NavInfo spatial index found for table '{}'", tableName);
+        return SpatialIndex::NavInfo;
+    }
+    switch (spatialIndexEnabled)
     {
     case 0:
         mapget::log().warn("No spatial index found for table '{}'", tableName);
@@ -95,6 +134,34 @@ Database::~Database()
     }
 }
 
+[[nodiscard]] std::vector<TableMetadata> Database::GetTablesMetadata() const
+{
+    std::vector<TableMetadata> tables;
+    SQLite::Statement stmt{m_db, R"SQL(
+        SELECT
+            g.f_table_name,
+            g.f_geometry_column,
+            g.geometry_type,
+            g.srid,
+            g.spatial_index_enabled,
+            (SELECT p.name FROM pragma_table_info(g.f_table_name) AS p WHERE p.pk = 1)
+        FROM geometry_columns AS g;
+    )SQL"};
+    while (stmt.executeStep())
+    {
+        const auto primaryKey = stmt.getColumn(5);
+        tables.emplace_back(TableMetadata{
+            .tableName = stmt.getColumn(0),
+            .geometryColumn = stmt.getColumn(1),
+            .geometryType = stmt.getColumn(2).getInt(),
+            .srid = stmt.getColumn(3).getInt(),
+            .spatialIndexEnabled = stmt.getColumn(4).getInt(),
+            .primaryKey = primaryKey.isNull() ? std::nullopt : std::optional{primaryKey.getString()}
+        });
+    }
+    return tables;
+}
+
 [[nodiscard]] std::vector<std::string> Database::GetTablesNames() const
 {
     std::vector<std::string> tables;
@@ -108,6 +175,22 @@ Database::~Database()
     return tables;
 }
 
+[[nodiscard]] std::vector<PyramidLevel> Database::GetPyramidLevels() const
+{
+    std::vector<PyramidLevel> levels;
+    SQLite::Statement stmt{m_db, R"SQL(
+        SELECT table_name, level_table, max_zoom FROM pyramid_levels ORDER BY max_zoom;
+    )SQL"};
+    while (stmt.executeStep())
+    {
+        levels.push_back({
+            boost::to_lower_copy(stmt.getColumn(0).getString()),
+            stmt.getColumn(1).getString(),
+            static_cast<uint16_t>(stmt.getColumn(2).getInt())});
+    }
+    return levels;
+}
+
 void Database::FillTableAttributes(TableInfo& tableInfo) const
 {
     // PRAGMA_TABLE_INFO gives unreliable results that may differ 
@@ -146,6 +229,7 @@ void Database::FillTableAttributes(TableInfo& tableInfo) const
 
 [[nodiscard]] GeometriesView Database::GetGeometries(const TableInfo& tableInfo, const Mbr& mbr) const
 {
+    ScopedSpan span{"prepare"};
     SQLite::Statement stmt{m_db, tableInfo.GetSqlQuery()};
     double xScaling = 1;
     double yScaling = 1;
@@ -160,10 +244,61 @@ void Database::FillTableAttributes(TableInfo& tableInfo) const
     stmt.bind("@yMin", mbr.ymin / yScaling);
     stmt.bind("@xMax", mbr.xmax / xScaling);
     stmt.bind("@yMax", mbr.ymax / yScaling);
-    mapget::log().debug("Getting geometries with an SQL query: {}", stmt.getExpandedSQL());
+    if (mapget::log().should_log(spdlog::level::debug))
+    {
+        // expanding the SQL is not free, so it's only done when it's actually logged
+        mapget::log().debug("Getting geometries with an SQL query: {}", stmt.getExpandedSQL());
+    }
     return GeometriesView{std::move(stmt), tableInfo};
 }
 
+[[nodiscard]] std::vector<std::string> Database::ExplainQueryPlan(const std::string& sql) const
+{
+    SQLite::Statement stmt{m_db, "EXPLAIN QUERY PLAN " + sql};
+    std::vector<std::string> plan;
+    std::unordered_map<int, size_t> depthById;
+    while (stmt.executeStep())
+    {
+        const auto id = stmt.getColumn("id").getInt();
+        const auto parentIt = depthById.find(stmt.getColumn("parent").getInt());
+        const auto depth = parentIt == depthById.end() ? 0 : parentIt->second + 1;
+        depthById[id] = depth;
+        plan.push_back(std::string(depth * 2, ' ') + stmt.getColumn("detail").getString());
+    }
+    return plan;
+}
+
+[[nodiscard]] uint64_t Database::EstimateRowsCount(const std::string& tableName) const
+{
+    if (m_db.tableExists("sqlite_stat1"))
+    {
+        // the first number of a stat is the number of rows in the table
+        SQLite::Statement statStmt{m_db, "SELECT stat FROM sqlite_stat1 WHERE tbl = ? LIMIT 1;"};
+        statStmt.bind(1, tableName);
+        if (statStmt.executeStep())
+        {
+            return std::strtoull(statStmt.getColumn(0).getText(), nullptr, 10);
+        }
+    }
+    SQLite::Statement stmt{m_db, fmt::format("SELECT MAX(rowid) FROM \"{}\";", tableName)};
+    return stmt.executeStep() ? static_cast<uint64_t>(stmt.getColumn(0).getInt64()) : 0;
+}
+
+[[nodiscard]] PageCacheStatus Database::GetPageCacheStatus() const
+{
+    const auto getStatus = [this](int status) -> int64_t {
+        int current = 0;
+        int highwater = 0;
+        sqlite3_db_status(m_db.getHandle(), status, &current, &highwater, 0);
+        return current;
+    };
+    return {
+        .usedBytes = getStatus(SQLITE_DBSTATUS_CACHE_USED),
+        .hits = getStatus(SQLITE_DBSTATUS_CACHE_HIT),
+        .misses = getStatus(SQLITE_DBSTATUS_CACHE_MISS)
+    };
+}
+
 [[nodiscard]] std::string Database::GetPrimaryKeyColumnName(const std::string& tableName) const
 {
     SQLite::Statement stmt{m_db, fmt::format(R"SQL(
@@ -22,11 +22,15 @@
 
 #include "GeometriesView.h"
 #include "GeometryType.h"
+#include "Mbr.h"
+#include "Metrics.h"
 #include "SqlStatements.h"
 #include "TableInfo.h"
 
 #include <mapget/log.h>
 #include <SQLiteCpp/Database.h>
+#include <optional>
+#include <string_view>
 #include <unordered_map>
 
 namespace SpatialiteDatasource {
@@ -37,11 +41,39 @@ struct GeometryColumnInfo
     int type;         /// Geometry type (POINT, LINESTRING, POLYGON, ...)
 };
 
-struct Mbr
+/**
+ * @brief Throw if the geometry column SRID is not WGS84
+ */
+void CheckSrid(const std::string& tableName, int srid);
+
+/**
+ * @brief Metadata of a table with a geometry column, read for all tables at once
+ */
+struct TableMetadata
+{
+    std::string tableName;
+    std::string geometryColumn;
+    int geometryType;                      /// Geometry type (POINT, LINESTRING, POLYGON, ...)
+    int srid;
+    int spatialIndexEnabled;               /// 'spatial_index_enabled' value of 'geometry_columns'
+    std::optional<std::string> primaryKey; /// Primary key column if the table has one
+};
+
+/**
+ * @brief Simplified copy of a layer table in the pyramid database
+ */
+struct PyramidLevel
 {
-    double xmin, ymin, xmax, ymax;
+    std::string table;      /// Layer table
+    std::string levelTable; /// Simplified copy of the layer table
+    uint16_t maxZoom;       /// Last zoom level the copy is simplified for
 };
 
+/**
+ * @brief Schema name of the database attached to a connection
+ */
+inline constexpr std::string_view AttachedSchemaName = "source";
+
 /**
  * @brief Class for reading spatialite geometries from a database
  */
@@ -49,11 +81,21 @@ class Database
 {
 public:
     /**
-     * @brief Construct a new Database object
+     * @brief Construct a new Database object. The statements of the connection are interrupted
+     *  once the deadline of the thread running them expires @sa Deadline
      * 
      * @param mapPath Path to a spatialite database
      */
     explicit Database(const std::filesystem::path& dbPath);
+
+    /**
+     * @brief Construct a new Database object with another database attached as 'source',
+     *  tables which aren't in the main database are looked up in the attached one
+     * 
+     * @param dbPath Path to a spatialite database
+     * @param attachedDbPath Path to the database to attach
+     */
+    Database(const std::filesystem::path& dbPath, const std::filesystem::path& attachedDbPath);
     ~Database();
 
     /**
@@ -69,11 +111,29 @@ public:
      */
     [[nodiscard]] SpatialIndex GetSpatialIndexType(const std::string& tableName) const;
 
+    /**
+     * @brief Get the spatial index type of the given table
+     * 
+     * @param tableName Table name
+     * @param spatialIndexEnabled 'spatial_index_enabled' value of 'geometry_columns'
+     */
+    [[nodiscard]] SpatialIndex GetSpatialIndexType(const std::string& tableName, int spatialIndexEnabled) const;
+
+    /**
+     * @brief Get metadata of all the tables that have a geometry column with a single query
+     */
+    [[nodiscard]] std::vector<TableMetadata> GetTablesMetadata() const;
+
     /**
      * @brief Get names of the tables that have a geometry column
      */
     [[nodiscard]] std::vector<std::string> GetTablesNames() const;
 
+    /**
+     * @brief Get the levels of a pyramid database, sorted by the zoom level
+     */
+    [[nodiscard]] std::vector<PyramidLevel> GetPyramidLevels() const;
+
     /**
      * @brief Fill a description of additional attributes (all columns besides primary key and geometry)
      */
@@ -113,6 +173,25 @@ public:
      * @return Geometry view that iterates over geometries
      */
     [[nodiscard]] GeometriesView GetGeometries(const TableInfo& tableInfo, const Mbr& mbr) const;
+
+    /**
+     * @brief Get the plan of the query
+     * 
+     * @param sql Query with all the parameters expanded
+     * @return 'EXPLAIN QUERY PLAN' rows, indented by their depth in the plan
+     */
+    [[nodiscard]] std::vector<std::string> ExplainQueryPlan(const std::string& sql) const;
+
+    /**
+     * @brief Estimate the number of rows in the table cheaply, 
+     *  from 'sqlite_stat1' if the database was analyzed or from the max rowid otherwise
+     */
+    [[nodiscard]] uint64_t EstimateRowsCount(const std::string& tableName) const;
+
+    /**
+     * @brief Get the page cache statistics of the connection
+     */
+    [[nodiscard]] PageCacheStatus GetPageCacheStatus() const;
         
 private:
     const SQLite::Database m_db;
@@ -0,0 +1,100 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "DatabasePool.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace SpatialiteDatasource {
+
+DatabasePool::Connection::Connection(DatabasePool& pool, const Database& db) noexcept
+    : m_pool{&pool}
+    , m_db{&db}
+{}
+
+DatabasePool::Connection::~Connection()
+{
+    if (m_pool != nullptr)
+    {
+        m_pool->Release(*m_db);
+    }
+}
+
+DatabasePool::Connection::Connection(Connection&& other) noexcept
+    : m_pool{std::exchange(other.m_pool, nullptr)}
+    , m_db{std::exchange(other.m_db, nullptr)}
+{}
+
+DatabasePool::DatabasePool(const std::filesystem::path& dbPath, size_t size, const std::filesystem::path& attachedDbPath)
+{
+    if (size == 0)
+    {
+        throw std::runtime_error{"Database pool must have at least one connection"};
+    }
+    m_connections.reserve(size);
+    m_available.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto db = attachedDbPath.empty() 
+            ? std::make_unique<Database>(dbPath) 
+            : std::make_unique<Database>(dbPath, attachedDbPath);
+        m_available.push_back(m_connections.emplace_back(std::move(db)).get());
+    }
+}
+
+[[nodiscard]] DatabasePool::Connection DatabasePool::Acquire()
+{
+    std::unique_lock lock{m_mutex};
+    m_released.wait(lock, [this] { return !m_available.empty(); });
+    const auto* db = m_available.back();
+    m_available.pop_back();
+    return Connection{*this, *db};
+}
+
+[[nodiscard]] size_t DatabasePool::Size() const noexcept
+{
+    return m_connections.size();
+}
+
+[[nodiscard]] PageCacheStatus DatabasePool::GetPageCacheStatus() const
+{
+    PageCacheStatus total;
+    for (const auto& connection : m_connections)
+    {
+        const auto status = connection->GetPageCacheStatus();
+        total.usedBytes += status.usedBytes;
+        total.hits += status.hits;
+        total.misses += status.misses;
+    }
+    return total;
+}
+
+void DatabasePool::Release(const Database& db)
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_available.push_back(&db);
+    }
+    m_released.notify_one();
+}
+
+} // namespace SpatialiteDatasource
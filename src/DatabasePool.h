@@ -0,0 +1,98 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "Database.h"
+
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Pool of read-only connections to a spatialite database,
+ *  so that queries from different threads don't wait for each other
+ */
+class DatabasePool
+{
+public:
+    /**
+     * @brief Connection borrowed from the pool, it's returned to the pool on destruction
+     */
+    class Connection
+    {
+    public:
+        Connection(DatabasePool& pool, const Database& db) noexcept;
+        ~Connection();
+
+        Connection(const Connection&) = delete;
+        Connection(Connection&& other) noexcept;
+        Connection& operator=(const Connection&) = delete;
+        Connection& operator=(Connection&&) = delete;
+
+        [[nodiscard]] const Database& operator*() const noexcept { return *m_db; }
+        [[nodiscard]] const Database* operator->() const noexcept { return m_db; }
+
+    private:
+        DatabasePool* m_pool;
+        const Database* m_db;
+    };
+
+    /**
+     * @brief Construct a new Database Pool object
+     * 
+     * @param dbPath Path to a spatialite database
+     * @param size Number of connections
+     * @param attachedDbPath Path to a database attached to every connection, none if empty
+     */
+    DatabasePool(const std::filesystem::path& dbPath, size_t size, const std::filesystem::path& attachedDbPath = {});
+
+    /**
+     * @brief Borrow a connection, waits until one is available
+     */
+    [[nodiscard]] Connection Acquire();
+
+    /**
+     * @brief Get the number of connections in the pool
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Get the page cache statistics summed over all connections
+     */
+    [[nodiscard]] PageCacheStatus GetPageCacheStatus() const;
+
+private:
+    void Release(const Database& db);
+
+private:
+    std::vector<std::unique_ptr<Database>> m_connections;
+
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    std::vector<const Database*> m_available;
+};
+
+} // namespace SpatialiteDatasource
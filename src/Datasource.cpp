@@ -19,25 +19,119 @@
 // SOFTWARE.
 
 #include "Datasource.h"
+#include "Deadline.h"
+#include "FeatureBudget.h"
 #include "MapgetFeature.h"
+#include "PointClustering.h"
+#include "QueryPlanAudit.h"
 
 #include <mapget/log.h>
+#include <sqlite3.h>
+#include <boost/container_hash/hash.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <optional>
 #include <stdexcept>
-#include <ranges>
+#include <thread>
 
 namespace SpatialiteDatasource {
 
+namespace {
+
+[[nodiscard]] size_t GetPoolSize(const DatabasePoolOptions& options)
+{
+    if (options.connections != 0)
+    {
+        return options.connections;
+    }
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+} // namespace
+
 Datasource::Datasource(ConfigLoader&& configLoader)
     : m_db{configLoader.GetDatasourceOptions().mapPath}
     , m_ds{mapget::DataSourceInfo::fromJson(configLoader.GenerateDatasourceConfig(m_db))}
-    , m_tablesInfo{configLoader.LoadTablesInfo(m_db)}
+    , m_dbPool{configLoader.GetDatasourceOptions().mapPath, GetPoolSize(configLoader.GetDatabasePoolOptions())}
+    , m_decodePipeline{configLoader.GetDecodePipelineOptions()}
+    , m_heavyTileSplitter{configLoader.GetHeavyTileOptions(), GetPoolSize(configLoader.GetDatabasePoolOptions()),
+        [this](const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom) { return ReadFeatures(tableInfo, mbr, zoom); }}
+    , m_tileBatcher{configLoader.GetTileBatchingOptions(), 
+        [this](const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom) { 
+            return m_heavyTileSplitter.Read(tableInfo, mbr, zoom); 
+        }}
+    , m_slowQueryLog{configLoader.GetSlowQueryLogOptions()}
+    , m_tracer{configLoader.GetTracingOptions()}
+    , m_tileTimeout{configLoader.GetTileDeadlineOptions().timeout}
+    , m_tablesInfo{configLoader.LoadLazyTablesInfo(m_db, m_dbPool)}
     , m_port{configLoader.GetDatasourceOptions().port}
+    , m_metricsOptions{configLoader.GetMetricsOptions()}
 {
-    for (const auto& table : std::views::keys(m_tablesInfo))
+    std::vector<PyramidLevel> pyramidLevels;
+    if (const auto& pyramidPath = configLoader.GetPyramidOptions().path; !pyramidPath.empty())
+    {
+        pyramidLevels = LoadPyramidLevels(pyramidPath, configLoader.GetDatasourceOptions().mapPath, 
+            GetPoolSize(configLoader.GetDatabasePoolOptions()));
+    }
+
+    std::vector<const TableInfo*> loadedTablesInfo;
+    for (auto& [table, tableInfo] : m_tablesInfo)
     {
         m_featuresTilesByTable[table];
+        m_metrics.layers[table];
+        m_layerOptions.emplace(table, configLoader.GetLayerOptions(table));
+        // the pyramid levels aren't in the map database, they always have a spatial index
+        if (tableInfo.IsLoaded() && !m_pyramidTables.contains(table))
+            loadedTablesInfo.push_back(&tableInfo.Get(m_dbPool));
+    }
+    AuditQueryPlans(m_db, loadedTablesInfo, configLoader.GetQueryPlanAuditOptions());
+
+    for (const auto& level : pyramidLevels)
+    {
+        auto& layerOptions = m_layerOptions.at(level.table);
+        layerOptions.zoomSources.push_back({level.maxZoom, level.levelTable});
+        std::ranges::stable_sort(layerOptions.zoomSources, {}, &ZoomSource::maxZoom);
+        m_layerOptions.at(level.levelTable) = layerOptions;
+    }
+}
+
+[[nodiscard]] std::vector<PyramidLevel> Datasource::LoadPyramidLevels(
+    const std::filesystem::path& pyramidPath, const std::filesystem::path& mapPath, size_t poolSize)
+{
+    m_pyramidPool.emplace(pyramidPath, poolSize, mapPath);
+    std::vector<PyramidLevel> levels;
+    for (auto& level : m_pyramidPool->Acquire()->GetPyramidLevels())
+    {
+        const auto layerIt = m_tablesInfo.find(level.table);
+        if (layerIt == m_tablesInfo.end())
+        {
+            mapget::log().warn("Pyramid level '{}' is skipped, table '{}' isn't a layer", level.levelTable, level.table);
+            continue;
+        }
+        // the layer may be loaded lazily, so the level is checked against it on the first use
+        auto load = [this, level](const Database& db) {
+            const auto& layerInfo = m_tablesInfo.at(level.table).Get(m_dbPool);
+            TableInfo levelInfo{level.levelTable, db};
+            if (levelInfo.geometryType != layerInfo.geometryType || levelInfo.dimension != layerInfo.dimension)
+            {
+                throw std::runtime_error{fmt::format(
+                    "Geometry of pyramid level '{}' differs from '{}', the pyramid must be rebuilt", level.levelTable, level.table)};
+            }
+            // the levels have all the columns of their layer table, the relations are resolved in the attached map
+            levelInfo.attributes = layerInfo.attributes;
+            levelInfo.scaling = layerInfo.scaling;
+            return levelInfo;
+        };
+        if (!m_tablesInfo.try_emplace(level.levelTable, LazyTableInfo::LoadFunction{std::move(load)}).second)
+        {
+            throw std::runtime_error{fmt::format("Pyramid level '{}' has the name of a table of the map", level.levelTable)};
+        }
+        m_pyramidTables.insert(level.levelTable);
+        levels.push_back(std::move(level));
     }
+    mapget::log().info("Loaded {} pyramid levels from '{}'", levels.size(), pyramidPath.string());
+    return levels;
 }
 
 [[nodiscard]] std::string Datasource::GetLayerIdFromTypeId(const std::string& typeId)
@@ -56,6 +150,15 @@ Datasource::Datasource(ConfigLoader&& configLoader)
 
 void Datasource::Run()
 {
+    Start("0.0.0.0");
+    mapget::log().info("Running on port {}...", m_ds.port());
+    m_ds.waitForSignal();
+    Stop();
+}
+
+uint16_t Datasource::Start(const std::string& host)
+{
+    m_isStopping = false;
     m_ds.onTileFeatureRequest(
         [this](auto&& tile)
         {
@@ -83,13 +186,40 @@ void Datasource::Run()
             }
         }
     );
-    m_ds.go("0.0.0.0", m_port);
-    mapget::log().info("Running on port {}...", m_ds.port());
-    m_ds.waitForSignal();
+    if (m_metricsOptions.port != 0)
+    {
+        m_metricsServer.emplace(m_metricsOptions.host, m_metricsOptions.port, 
+            [this] { return CollectMetrics(); }, 
+            [this] { return m_slowQueryLog.Dump(); });
+    }
+    m_ds.go(host, m_port);
+    return m_ds.port();
+}
+
+void Datasource::Stop()
+{
+    // the running queries are interrupted, so the server doesn't wait for them
+    m_isStopping = true;
+    if (m_ds.isRunning())
+    {
+        m_ds.stop();
+    }
+    m_metricsServer.reset();
 }
 
 void Datasource::FillTileWithGeometries(const mapget::TileFeatureLayer::Ptr& tile)
 {
+    // the trace must outlive the spans
+    const auto trace = m_tracer.StartTrace();
+    const TraceScope traceScope{trace.get()};
+    // the queries of the request are interrupted after the timeout or on shutdown
+    const Deadline deadline{
+        m_tileTimeout.count() != 0 ? Deadline::Clock::now() + m_tileTimeout : Deadline::Clock::time_point::max(),
+        &m_isStopping};
+    const DeadlineScope deadlineScope{&deadline};
+    ScopedSpan span{"tile"};
+    span.SetArg("tileId", tile->tileId().value_);
+
     const auto layerInfo = tile->layerInfo();
     for (const auto& featureType : layerInfo->featureTypes_)
     {
@@ -99,41 +229,285 @@ void Datasource::FillTileWithGeometries(const mapget::TileFeatureLayer::Ptr& til
         {
             throw std::runtime_error{fmt::format("Unknown table '{}'", tableName)};
         }
-        CreateGeometries(tile, tableInfoIt->second);
+        CreateGeometries(tile, tableInfoIt->second.Get(m_dbPool));
     }
 }
 
+[[nodiscard]] size_t Datasource::TileRequestKeyHash::operator()(const TileRequestKey& key) const noexcept
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, key.table);
+    boost::hash_combine(seed, key.tileId);
+    return seed;
+}
+
 void Datasource::CreateGeometries(const mapget::TileFeatureLayer::Ptr& tile, const TableInfo& tableInfo)
 {
     const auto tid = tile->tileId();
-    const Mbr mbr{
-        .xmin = tid.sw().x,
-        .ymin = tid.sw().y,
-        .xmax = tid.ne().x,
-        .ymax = tid.ne().y
-    };
-
-    constexpr size_t FeaturesBufferSize = 300;
-    std::vector<int> featuresIds;
-    featuresIds.reserve(FeaturesBufferSize);
-
-    auto geometries = m_db.GetGeometries(tableInfo, mbr);
-    for (auto geometry : geometries)
-    {
-        const auto featureId = geometry.GetId();
-        auto feature = tile->newFeature(tableInfo.name, {{"id", featureId}});
+    ++m_metrics.tileRequests;
+    ScopedSpan tableSpan{"table"};
+    tableSpan.SetArg("table", tableInfo.name);
+
+    const auto [features, isCoalesced] = ReadSharedTileFeatures(tableInfo, tid);
+    tableSpan.SetArg("coalesced", isCoalesced);
+    if (isCoalesced)
+    {
+        const auto coalesced = ++m_metrics.coalescedTileRequests;
+        mapget::log().debug("Request of tile {} for table '{}' was coalesced with an in-flight one ({} in total)",
+            tid.value_, tableInfo.name, coalesced);
+    }
+
+    ScopedSpan appendSpan{"append"};
+    const auto appendStart = std::chrono::steady_clock::now();
+    const auto& layerOptions = m_layerOptions.at(tableInfo.name);
+    auto& layerMetrics = m_metrics.layers.at(tableInfo.name);
+    const auto levelOfDetail = GetLevelOfDetail(layerOptions, tableInfo, tid.z());
+    size_t vertices = 0;
+    if (levelOfDetail.clusterCellSize > 0.)
+    {
+        // the points are only sent as clusters, so they can't be located in the tile
+        const auto clusters = AppendClusters(tile, tableInfo, *features, levelOfDetail.clusterCellSize);
+        layerMetrics.clusters.fetch_add(clusters, std::memory_order_relaxed);
+        appendSpan.SetArg("clusters", clusters);
+    }
+    else
+    {
+        // the features may be shared with coalesced requests, so the budget selects a copy of them
+        const auto selected = SelectFeaturesWithinBudget(features->features, layerOptions, tableInfo.geometryType);
+        if (selected.has_value())
+        {
+            const auto dropped = features->features.size() - selected->size();
+            layerMetrics.budgetDroppedFeatures.fetch_add(dropped, std::memory_order_relaxed);
+            layerMetrics.truncatedTiles.fetch_add(1, std::memory_order_relaxed);
+            appendSpan.SetArg("truncated", dropped);
+            mapget::log().info("Tile {} of '{}' is truncated to the budget: {} of {} features are dropped",
+                tid.value_, tableInfo.name, dropped, features->features.size());
+        }
+        const auto& appended = selected.has_value() ? *selected : features->features;
+        for (const auto* bufferedFeature : appended)
+        {
+            auto feature = tile->newFeature(tableInfo.name, {{"id", bufferedFeature->GetId()}});
+            MapgetFeature geometryFabric{*feature};
+            bufferedFeature->AddTo(geometryFabric);
+            vertices += bufferedFeature->GetPointsCount();
+        }
+        // the features dropped by the budget aren't in the tile, so they can't be located in it
+        RegisterLocatableFeatures(tableInfo.name, tid, appended);
+    }
+    layerMetrics.appendLatency.Observe(std::chrono::steady_clock::now() - appendStart);
+    layerMetrics.vertices.fetch_add(vertices, std::memory_order_relaxed);
+    appendSpan.SetArg("features", features->features.size());
+    appendSpan.SetArg("vertices", vertices);
+}
+
+[[nodiscard]] Datasource::TileRequests::Result Datasource::ReadSharedTileFeatures(
+    const TableInfo& tableInfo, mapget::TileId tileId)
+{
+    while (true)
+    {
+        try
+        {
+            // Popular tiles are often requested by several clients at the same time,
+            // so the identical requests wait for the first one instead of querying the db again
+            return m_tileRequests.Do(
+                TileRequestKey{tableInfo.name, tileId.value_},
+                [&] { return ReadTileFeatures(tableInfo, tileId); });
+        }
+        catch (const DeadlineExceeded& e)
+        {
+            // a coalesced or batched read runs under the deadline of the request that started it
+            const auto* const deadline = Deadline::Current();
+            if (deadline == nullptr || deadline->IsExpired())
+                throw;
+            ++m_metrics.retriedTileReads;
+            mapget::log().debug("Retrying tile {} of '{}', the shared read ran out of time: {}", 
+                tileId.value_, tableInfo.name, e.what());
+        }
+    }
+}
+
+[[nodiscard]] const TableInfo& Datasource::GetSourceTableInfo(const TableInfo& tableInfo, uint16_t zoom)
+{
+    for (const auto& source : m_layerOptions.at(tableInfo.name).zoomSources)
+    {
+        if (zoom <= source.maxZoom)
+        {
+            return m_tablesInfo.at(source.table).Get(GetPool(source.table));
+        }
+    }
+    return tableInfo;
+}
+
+[[nodiscard]] DatabasePool& Datasource::GetPool(const std::string& table)
+{
+    return m_pyramidTables.contains(table) ? *m_pyramidPool : m_dbPool;
+}
+
+[[nodiscard]] size_t Datasource::AppendClusters(
+    const mapget::TileFeatureLayer::Ptr& tile, const TableInfo& tableInfo, const TileFeatures& features, double cellSize)
+{
+    PointClusterGrid grid{cellSize};
+    for (const auto* feature : features.features)
+    {
+        feature->ForEachPoint([&grid](const mapget::Point& point) { grid.Add(point); });
+    }
+
+    const auto clusters = grid.GetClusters();
+    for (size_t i = 0; i < clusters.size(); ++i)
+    {
+        auto feature = tile->newFeature(tableInfo.name, {{"id", GetClusterId(tile->tileId().value_, clusters[i].cell)}});
         MapgetFeature geometryFabric{*feature};
-        geometry.AddTo(geometryFabric);
-        featuresIds.push_back(featureId);
+        geometryFabric.AddGeometry(GeometryType::Point, 1).AddPoint(clusters[i].center);
+        geometryFabric.AddAttribute("count", static_cast<int64_t>(clusters[i].count));
     }
-    auto& [lock, map] = m_featuresTilesByTable.at(tableInfo.name);
+    return clusters.size();
+}
+
+[[nodiscard]] Datasource::TileFeaturesPtr Datasource::ReadTileFeatures(const TableInfo& tableInfo, mapget::TileId tileId)
+{
+    const auto& sourceTableInfo = GetSourceTableInfo(tableInfo, tileId.z());
+    auto tileFeatures = m_tileBatcher.Read(sourceTableInfo, tileId);
+    if (m_layerOptions.at(tableInfo.name).exactIntersection)
+    {
+        tileFeatures = SelectIntersectingFeatures(tableInfo, tileFeatures, GetTileMbr(tileId));
+    }
+    return tileFeatures;
+}
+
+void Datasource::RegisterLocatableFeatures(
+    const std::string& table, mapget::TileId tileId, const std::vector<const BufferedFeature*>& features)
+{
+    auto& [lock, map] = m_featuresTilesByTable.at(table);
+    std::lock_guard lockGuard{lock};
+    for (const auto* feature : features)
+    {
+        map[feature->GetId()] = tileId; // overwriting is fine
+    }
+}
+
+[[nodiscard]] Datasource::TileFeaturesPtr Datasource::SelectIntersectingFeatures(
+    const TableInfo& tableInfo, const TileFeaturesPtr& tileFeatures, const Mbr& tileMbr)
+{
+    ScopedSpan span{"intersect"};
+    auto result = std::make_shared<TileFeatures>();
+    result->buffer = tileFeatures->buffer;
+    result->features.reserve(tileFeatures->features.size());
+    for (const auto* feature : tileFeatures->features)
     {
-        std::lock_guard lockGuard{lock};
-        for (const auto featureId : featuresIds)
+        // features without points can't be tested, so they are kept like in the MBR selection
+        if (feature->GetPointsCount() == 0 || feature->Intersects(tileMbr))
         {
-            map[featureId] = tid; // overwriting is fine
+            result->features.push_back(feature);
         }
     }
+
+    const auto rejected = tileFeatures->features.size() - result->features.size();
+    m_metrics.layers.at(tableInfo.name).intersectionRejectedFeatures.fetch_add(rejected, std::memory_order_relaxed);
+    span.SetArg("rejected", rejected);
+    return result;
+}
+
+[[nodiscard]] BufferedFeatures Datasource::ReadFeatures(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom)
+{
+    const auto start = std::chrono::steady_clock::now();
+    ScopedSpan span{"read"};
+    if (span.IsActive())
+    {
+        // the table differs from the requested one if it's a zoom source
+        span.SetArg("table", tableInfo.name);
+        span.SetArg("mbr", nlohmann::json::array({mbr.xmin, mbr.ymin, mbr.xmax, mbr.ymax}));
+    }
+    const auto connection = GetPool(tableInfo.name).Acquire();
+    const auto acquireTime = std::chrono::steady_clock::now() - start;
+    auto geometries = connection->GetGeometries(tableInfo, mbr);
+    const auto levelOfDetail = GetReadLevelOfDetail(m_layerOptions.at(tableInfo.name), tableInfo, mbr, zoom);
+    DecodeStats stats;
+    BufferedFeatures features;
+    try
+    {
+        features = m_decodePipeline.Decode(geometries, levelOfDetail, stats);
+    }
+    catch (const SQLite::Exception& e)
+    {
+        if (e.getErrorCode() != SQLITE_INTERRUPT)
+            throw;
+        m_metrics.layers.at(tableInfo.name).interruptedQueries.fetch_add(1, std::memory_order_relaxed);
+        throw DeadlineExceeded{fmt::format("Query of '{}' was interrupted by the tile request deadline after {}ms", 
+            tableInfo.name, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count())};
+    }
+    if (span.IsActive())
+    {
+        span.SetArg("culled", stats.culledFeatures);
+        span.SetArg("truncated", stats.isReadTruncated);
+    }
+    if (stats.culledFeatures != 0)
+    {
+        mapget::log().debug("Culled {} sub-pixel features of '{}' at zoom {}", 
+            stats.culledFeatures, tableInfo.name, zoom);
+    }
+    if (stats.isReadTruncated)
+    {
+        mapget::log().debug("Read of '{}' at zoom {} stopped at the budget after {} features", 
+            tableInfo.name, zoom, features.size());
+    }
+    const auto totalTime = std::chrono::steady_clock::now() - start;
+    const auto queryTime = totalTime - acquireTime - stats.requestThreadDecodeTime;
+
+    if (m_slowQueryLog.IsSlow(totalTime))
+    {
+        // the plan is only explained for the slow queries, they are rare and the plan is what's needed to fix them
+        auto sql = geometries.GetExpandedSql();
+        std::vector<std::string> plan;
+        try
+        {
+            plan = connection->ExplainQueryPlan(sql);
+        }
+        catch (const std::exception& e)
+        {
+            plan.push_back(fmt::format("Failed to explain the query plan: {}", e.what()));
+        }
+        m_slowQueryLog.Record({
+            .time = std::chrono::system_clock::now(),
+            .table = tableInfo.name,
+            .mbr = mbr,
+            .sql = std::move(sql),
+            .plan = std::move(plan),
+            .rows = features.size(),
+            .totalTime = totalTime,
+            .acquireTime = acquireTime,
+            .queryTime = queryTime,
+            .decodeTime = stats.decodeTime
+        });
+    }
+
+    auto& layerMetrics = m_metrics.layers.at(tableInfo.name);
+    layerMetrics.queryLatency.Observe(totalTime - stats.requestThreadDecodeTime);
+    layerMetrics.decodeLatency.Observe(stats.decodeTime);
+    layerMetrics.rows.fetch_add(features.size(), std::memory_order_relaxed);
+    layerMetrics.culledFeatures.fetch_add(stats.culledFeatures, std::memory_order_relaxed);
+    layerMetrics.truncatedReads.fetch_add(stats.isReadTruncated ? 1 : 0, std::memory_order_relaxed);
+    layerMetrics.blobBytes.fetch_add(stats.blobBytes, std::memory_order_relaxed);
+    layerMetrics.decodeArenaAllocations.fetch_add(stats.arenaAllocations, std::memory_order_relaxed);
+    layerMetrics.ObserveDecodeArenaBytes(stats.arenaBytes);
+    return features;
+}
+
+[[nodiscard]] std::string Datasource::CollectMetrics()
+{
+    std::unordered_map<std::string, size_t> locatableFeatures;
+    for (auto& [table, featuresTiles] : m_featuresTilesByTable)
+    {
+        std::shared_lock lockGuard{featuresTiles.lock};
+        locatableFeatures.emplace(table, featuresTiles.map.size());
+    }
+
+    auto pageCache = m_dbPool.GetPageCacheStatus();
+    const auto startupPageCache = m_db.GetPageCacheStatus();
+    pageCache.usedBytes += startupPageCache.usedBytes;
+    pageCache.hits += startupPageCache.hits;
+    pageCache.misses += startupPageCache.misses;
+
+    return FormatMetrics(m_metrics, locatableFeatures, pageCache);
 }
 
 [[nodiscard]] std::vector<mapget::LocateResponse> Datasource::LocateFeature(const mapget::LocateRequest& request)
@@ -152,7 +526,15 @@ void Datasource::CreateGeometries(const mapget::TileFeatureLayer::Ptr& tile, con
     auto& [lock, map] = m_featuresTilesByTable.at(table);
     {
         std::shared_lock lockGuard{lock};
-        response.tileKey_.tileId_ = map.at(static_cast<int>(*featureId));
+        const auto tileIt = map.find(static_cast<int>(*featureId));
+        if (tileIt == map.end())
+        {
+            ++m_metrics.locateMisses;
+            throw std::runtime_error{fmt::format(
+                "Failed to locate feature {} of '{}': it wasn't in any requested tile", *featureId, table)};
+        }
+        ++m_metrics.locateHits;
+        response.tileKey_.tileId_ = tileIt->second;
     }
 
     return responses;
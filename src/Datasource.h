@@ -20,13 +20,28 @@
 
 #pragma once
 
+#include "BufferedFeature.h"
 #include "Database.h"
+#include "DatabasePool.h"
+#include "DecodePipeline.h"
 #include "GeometryType.h"
+#include "HeavyTileSplitter.h"
+#include "LevelOfDetail.h"
+#include "Metrics.h"
+#include "MetricsServer.h"
+#include "SingleFlight.h"
+#include "SlowQueryLog.h"
 #include "TableInfo.h"
+#include "TileBatcher.h"
+#include "Tracing.h"
 #include "ConfigLoader.h"
 
 #include <mapget/http-datasource/datasource-server.h>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <optional>
+#include <unordered_set>
 
 namespace SpatialiteDatasource {
 
@@ -34,10 +49,23 @@ class Datasource
 {
 public:
     /**
-     * @brief Run the datasource server
+     * @brief Run the datasource server until a termination signal
      */
     void Run();
 
+    /**
+     * @brief Start the datasource server in the background
+     * 
+     * @param host Interface to listen on
+     * @return Port the server listens on, it's chosen by the system if the configured port is 0
+     */
+    uint16_t Start(const std::string& host);
+
+    /**
+     * @brief Stop the server started in the background
+     */
+    void Stop();
+
 private:
     explicit Datasource(ConfigLoader&& configLoader);
 
@@ -50,6 +78,22 @@ private:
         std::unordered_map<int /* featureId */, mapget::TileId> map;
     };
 
+    struct TileRequestKey
+    {
+        [[nodiscard]] bool operator==(const TileRequestKey&) const = default;
+
+        std::string table;
+        uint64_t tileId;
+    };
+
+    struct TileRequestKeyHash
+    {
+        [[nodiscard]] size_t operator()(const TileRequestKey& key) const noexcept;
+    };
+
+    using TileFeaturesPtr = std::shared_ptr<const TileFeatures>;
+    using TileRequests = SingleFlight<TileRequestKey, TileFeaturesPtr, TileRequestKeyHash>;
+
     [[nodiscard]] std::string GetLayerIdFromTypeId(const std::string& typeId);
 
     /**
@@ -74,15 +118,120 @@ private:
      * @param dimension Dimension of the geometries (2D/3D)
      */
     void CreateGeometries(const mapget::TileFeatureLayer::Ptr& tile, const TableInfo& tableInfo);
+
+    /**
+     * @brief Read the features of the table within the tile or wait for an identical in-flight read.
+     *  A read that ran out of the time of another request is retried while this request has time left
+     * 
+     * @param tableInfo Table which contains geometries
+     * @param tileId Tile to read the features for
+     */
+    [[nodiscard]] TileRequests::Result ReadSharedTileFeatures(const TableInfo& tableInfo, mapget::TileId tileId);
+
+    /**
+     * @brief Read and decode the features of the table within the tile
+     * 
+     * @param tableInfo Table which contains geometries
+     * @param tileId Tile to read the features for
+     */
+    [[nodiscard]] TileFeaturesPtr ReadTileFeatures(const TableInfo& tableInfo, mapget::TileId tileId);
+
+    /**
+     * @brief Remember the tile of the features sent in it for '/locate' requests
+     * 
+     * @param table Table of the features
+     * @param tileId Tile the features are sent in
+     * @param features Features appended to the tile
+     */
+    void RegisterLocatableFeatures(
+        const std::string& table, mapget::TileId tileId, const std::vector<const BufferedFeature*>& features);
+
+    /**
+     * @brief Open the pool of the pyramid database connections and add its levels to the tables info
+     * 
+     * @param pyramidPath Path to the pyramid database
+     * @param mapPath Path to the map database, it's attached to the pyramid connections
+     * @param poolSize Number of the pyramid connections
+     * @return Levels of the layers of the datasource
+     */
+    [[nodiscard]] std::vector<PyramidLevel> LoadPyramidLevels(
+        const std::filesystem::path& pyramidPath, const std::filesystem::path& mapPath, size_t poolSize);
+
+    /**
+     * @brief Get the table to read the features of the layer from for the tiles of the zoom level
+     * 
+     * @param tableInfo Table of the layer
+     * @param zoom Zoom level of the tile
+     * @return Info of the zoom source table or the given table info if there is no source for the zoom level
+     */
+    [[nodiscard]] const TableInfo& GetSourceTableInfo(const TableInfo& tableInfo, uint16_t zoom);
+
+    /**
+     * @brief Get the pool of the connections to the database of the table, the pyramid levels have their own
+     */
+    [[nodiscard]] DatabasePool& GetPool(const std::string& table);
+
+    /**
+     * @brief Add the points of the features to the tile as one cluster feature per occupied grid cell
+     * 
+     * @param tile Tile to add the clusters to
+     * @param tableInfo Table of the points
+     * @param features Features of the tile
+     * @param cellSize Size of a grid cell
+     * @return Number of added clusters
+     */
+    [[nodiscard]] size_t AppendClusters(const mapget::TileFeatureLayer::Ptr& tile, const TableInfo& tableInfo, 
+        const TileFeatures& features, double cellSize);
+
+    /**
+     * @brief Select the features which geometries intersect the tile, not only their MBRs
+     * 
+     * @param tableInfo Table which contains geometries
+     * @param tileFeatures Features selected by the MBR
+     * @param tileMbr MBR of the tile
+     */
+    [[nodiscard]] TileFeaturesPtr SelectIntersectingFeatures(
+        const TableInfo& tableInfo, const TileFeaturesPtr& tileFeatures, const Mbr& tileMbr);
+
+    /**
+     * @brief Read and decode the features of the table within the MBR on a connection from the pool
+     * 
+     * @param tableInfo Table which contains geometries
+     * @param mbr Minimum bounding rectangle
+     * @param zoom Zoom level of the requested tiles, selects the level of detail
+     */
+    [[nodiscard]] BufferedFeatures ReadFeatures(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom);
+
+    /**
+     * @brief Format the metrics for the '/metrics' endpoint
+     */
+    [[nodiscard]] std::string CollectMetrics();
 private:
     Database m_db;
     mapget::DataSourceServer m_ds;
     std::unordered_map<
         std::string, // typeId (table)
         FeatureTileMapThreadSafe> m_featuresTilesByTable;
-
-    const TablesInfo m_tablesInfo;
+    TileRequests m_tileRequests;
+    DatabasePool m_dbPool;
+    std::optional<DatabasePool> m_pyramidPool;
+    std::unordered_set<std::string> m_pyramidTables; /// Tables read from the pyramid database
+    DecodePipeline m_decodePipeline;
+    HeavyTileSplitter m_heavyTileSplitter;
+    TileBatcher m_tileBatcher;
+    DatasourceMetrics m_metrics;
+    SlowQueryLog m_slowQueryLog;
+    Tracer m_tracer;
+    const std::chrono::milliseconds m_tileTimeout; /// Deadline of a tile request, disabled if 0
+    std::atomic<bool> m_isStopping{false};         /// Cancels the running tile queries
+
+    LazyTablesInfo m_tablesInfo;
+    std::unordered_map<
+        std::string, // table
+        LayerOptions> m_layerOptions;
     const uint16_t m_port = 0;
+    const MetricsOptions m_metricsOptions;
+    std::optional<MetricsServer> m_metricsServer;
 };
 
 /**
@@ -0,0 +1,60 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Deadline.h"
+
+#include <utility>
+
+namespace SpatialiteDatasource {
+namespace {
+
+thread_local const Deadline* CurrentDeadline = nullptr;
+
+} // namespace
+
+Deadline::Deadline(Clock::time_point time, const std::atomic<bool>* isCancelled) noexcept
+    : m_time{time}
+    , m_isCancelled{isCancelled}
+{}
+
+[[nodiscard]] bool Deadline::IsExpired() const noexcept
+{
+    if (m_isCancelled != nullptr && m_isCancelled->load(std::memory_order_relaxed))
+        return true;
+
+    return Clock::now() >= m_time;
+}
+
+[[nodiscard]] const Deadline* Deadline::Current() noexcept
+{
+    return CurrentDeadline;
+}
+
+DeadlineScope::DeadlineScope(const Deadline* deadline) noexcept
+    : m_previous{std::exchange(CurrentDeadline, deadline)}
+{}
+
+DeadlineScope::~DeadlineScope()
+{
+    CurrentDeadline = m_previous;
+}
+
+} // namespace SpatialiteDatasource
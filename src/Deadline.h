@@ -0,0 +1,87 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Thrown if the queries of a read are interrupted by the deadline of the request that runs it
+ */
+class DeadlineExceeded : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Deadline of a tile request. The queries of the request are interrupted 
+ *  by the progress handler of the connection once it passes or the request is cancelled
+ */
+class Deadline
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Construct a new Deadline object
+     * 
+     * @param time Time after which the queries are interrupted
+     * @param isCancelled Flag that cancels the queries when set, none if nullptr
+     */
+    explicit Deadline(Clock::time_point time, const std::atomic<bool>* isCancelled = nullptr) noexcept;
+
+    /**
+     * @brief Check whether the deadline passed or the request was cancelled
+     */
+    [[nodiscard]] bool IsExpired() const noexcept;
+
+    /**
+     * @brief Get the deadline of the current thread, nullptr if the thread has none
+     */
+    [[nodiscard]] static const Deadline* Current() noexcept;
+
+private:
+    const Clock::time_point m_time;
+    const std::atomic<bool>* const m_isCancelled;
+};
+
+/**
+ * @brief Makes the deadline current for the thread within the scope
+ */
+class DeadlineScope
+{
+public:
+    explicit DeadlineScope(const Deadline* deadline) noexcept;
+    ~DeadlineScope();
+
+    DeadlineScope(const DeadlineScope&) = delete;
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+private:
+    const Deadline* m_previous;
+};
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,140 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "DecodeArena.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace SpatialiteDatasource {
+namespace {
+
+/// Arenas kept per thread, more are only needed if a thread decodes several requests at once
+constexpr size_t MaxPooledArenas = 4;
+
+[[nodiscard]] std::vector<std::unique_ptr<DecodeArena>>& GetThreadPool()
+{
+    thread_local std::vector<std::unique_ptr<DecodeArena>> pool;
+    return pool;
+}
+
+} // namespace
+
+void* DecodeArena::CountingResource::do_allocate(size_t bytes, size_t alignment)
+{
+    ++allocations;
+    this->bytes += bytes;
+    return m_upstream->allocate(bytes, alignment);
+}
+
+void DecodeArena::CountingResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+{
+    m_upstream->deallocate(ptr, bytes, alignment);
+}
+
+[[nodiscard]] bool DecodeArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+DecodeArena::DecodeArena()
+{
+    Rebuild();
+}
+
+[[nodiscard]] std::pmr::memory_resource* DecodeArena::GetResource() noexcept
+{
+    return &m_usage;
+}
+
+[[nodiscard]] size_t DecodeArena::GetUsedBytes() const noexcept
+{
+    return m_usage.bytes;
+}
+
+[[nodiscard]] size_t DecodeArena::GetHighWaterMark() const noexcept
+{
+    return std::max(m_highWaterMark, m_usage.bytes);
+}
+
+[[nodiscard]] uint64_t DecodeArena::GetUpstreamAllocations() const noexcept
+{
+    return m_upstream.allocations;
+}
+
+void DecodeArena::Reset()
+{
+    m_highWaterMark = std::max(m_highWaterMark, m_usage.bytes);
+    if (m_upstream.allocations == 0)
+    {
+        m_monotonic->release();
+        m_usage.ResetCounters();
+        return;
+    }
+
+    // the request didn't fit, so the buffer grows to everything it took including the alignment overhead
+    const auto neededSize = std::min(m_bufferSize + m_upstream.bytes, MaxRetainedBytes);
+    m_monotonic.reset();
+    if (neededSize > m_bufferSize)
+    {
+        m_buffer = std::make_unique<std::byte[]>(neededSize);
+        m_bufferSize = neededSize;
+    }
+    Rebuild();
+}
+
+void DecodeArena::Rebuild()
+{
+    m_upstream.ResetCounters();
+    m_usage.ResetCounters();
+    if (m_bufferSize == 0)
+        m_monotonic.emplace(&m_upstream);
+    else
+        m_monotonic.emplace(m_buffer.get(), m_bufferSize, &m_upstream);
+    m_usage.SetUpstream(&*m_monotonic);
+}
+
+DecodeArenaLease::~DecodeArenaLease()
+{
+    if (!m_arena)
+        return;
+
+    m_arena->Reset();
+    auto& pool = GetThreadPool();
+    if (pool.size() < MaxPooledArenas)
+    {
+        pool.push_back(std::move(m_arena));
+    }
+}
+
+[[nodiscard]] DecodeArenaLease AcquireDecodeArena()
+{
+    auto& pool = GetThreadPool();
+    if (pool.empty())
+    {
+        return DecodeArenaLease{std::make_unique<DecodeArena>()};
+    }
+    auto arena = std::move(pool.back());
+    pool.pop_back();
+    return DecodeArenaLease{std::move(arena)};
+}
+
+} // namespace SpatialiteDatasource
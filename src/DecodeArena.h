@@ -0,0 +1,132 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Monotonic arena for the transient allocations of decoding a single request.
+ *  Nothing is freed until the arena is reset, then the next request starts with a single buffer
+ *  as large as the previous requests needed, so a warmed-up arena doesn't call the allocator at all
+ */
+class DecodeArena
+{
+public:
+    /// Upper bound of the buffer kept between requests, a single huge tile shouldn't pin its memory forever
+    static constexpr size_t MaxRetainedBytes = 16 * 1024 * 1024;
+
+    DecodeArena();
+
+    DecodeArena(const DecodeArena&) = delete;
+    DecodeArena& operator=(const DecodeArena&) = delete;
+
+    /**
+     * @brief Get the memory resource to allocate from, not thread-safe
+     */
+    [[nodiscard]] std::pmr::memory_resource* GetResource() noexcept;
+
+    /**
+     * @brief Get the bytes allocated since the last reset
+     */
+    [[nodiscard]] size_t GetUsedBytes() const noexcept;
+
+    /**
+     * @brief Get the maximum of the bytes used by a single request since the arena was created
+     */
+    [[nodiscard]] size_t GetHighWaterMark() const noexcept;
+
+    /**
+     * @brief Get the number of allocator calls since the last reset, 
+     *  i.e. how often the request didn't fit into the retained buffer
+     */
+    [[nodiscard]] uint64_t GetUpstreamAllocations() const noexcept;
+
+    /**
+     * @brief Release all allocations and grow the retained buffer to what the last request needed
+     */
+    void Reset();
+
+private:
+    /**
+     * @brief Forwards to another resource and counts the calls and bytes
+     */
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit CountingResource(std::pmr::memory_resource* upstream) noexcept : m_upstream{upstream} {}
+
+        void SetUpstream(std::pmr::memory_resource* upstream) noexcept { m_upstream = upstream; }
+        void ResetCounters() noexcept { allocations = 0; bytes = 0; }
+
+        uint64_t allocations = 0;
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        std::pmr::memory_resource* m_upstream;
+    };
+
+    void Rebuild();
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_bufferSize = 0;
+    size_t m_highWaterMark = 0;
+    CountingResource m_upstream{std::pmr::new_delete_resource()}; /// Allocator calls past the buffer
+    std::optional<std::pmr::monotonic_buffer_resource> m_monotonic;
+    CountingResource m_usage{nullptr}; /// Bytes requested from the arena
+};
+
+/**
+ * @brief Arena taken from the pool of the current thread, it's reset and returned to the pool on destruction
+ */
+class DecodeArenaLease
+{
+public:
+    DecodeArenaLease(DecodeArenaLease&& other) noexcept = default;
+    DecodeArenaLease& operator=(DecodeArenaLease&&) = delete;
+    ~DecodeArenaLease();
+
+    DecodeArena* operator->() const noexcept { return m_arena.get(); }
+    DecodeArena& operator*() const noexcept { return *m_arena; }
+
+private:
+    explicit DecodeArenaLease(std::unique_ptr<DecodeArena>&& arena) noexcept : m_arena{std::move(arena)} {}
+    friend DecodeArenaLease AcquireDecodeArena();
+
+    std::unique_ptr<DecodeArena> m_arena;
+};
+
+/**
+ * @brief Take an arena from the pool of the current thread or create a new one if it's empty
+ */
+[[nodiscard]] DecodeArenaLease AcquireDecodeArena();
+
+} // namespace SpatialiteDatasource
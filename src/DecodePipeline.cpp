@@ -0,0 +1,362 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "DecodePipeline.h"
+#include "DecodeArena.h"
+#include "Tracing.h"
+
+#include <boost/asio/post.hpp>
+#include <boost/lockfree/queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace SpatialiteDatasource {
+namespace {
+
+constexpr size_t QueueCapacity = 64;
+
+using Clock = std::chrono::steady_clock;
+
+[[nodiscard]] int64_t ToMicroseconds(std::chrono::nanoseconds duration) noexcept
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+/**
+ * @brief Check the MBR from the blob header, so culled rows are neither decoded nor copied
+ */
+[[nodiscard]] bool IsCulled(const Geometry& geometry, const LevelOfDetail& levelOfDetail)
+{
+    if (levelOfDetail.minFeatureSize <= 0.)
+    {
+        return false;
+    }
+    const auto mbr = geometry.GetMbr();
+    return mbr.has_value() && levelOfDetail.IsCulled(*mbr);
+}
+
+[[nodiscard]] size_t CountVertices(const BufferedFeatures& features) noexcept
+{
+    size_t vertices = 0;
+    for (const auto& feature : features)
+    {
+        vertices += feature.GetPointsCount();
+    }
+    return vertices;
+}
+
+/**
+ * @brief Decode the row into the feature, the attributes are skipped if the level of detail doesn't send them
+ */
+template <class Row>
+void AddTo(Row&& row, BufferedFeature& feature, const LevelOfDetail& levelOfDetail)
+{
+    if (levelOfDetail.NeedsAttributes())
+        row.AddAttributesTo(feature);
+    row.AddGeometryTo(feature, levelOfDetail.precision);
+}
+
+/**
+ * @brief Decoding time split into attributes and geometries, only collected for traced requests
+ */
+struct DecodeBreakdown
+{
+    std::chrono::nanoseconds attributes{0};
+    std::chrono::nanoseconds geometries{0};
+
+    template <class Row>
+    void AddTo(Row&& row, BufferedFeature& feature, const LevelOfDetail& levelOfDetail)
+    {
+        const auto start = Clock::now();
+        if (levelOfDetail.NeedsAttributes())
+            row.AddAttributesTo(feature);
+        const auto attributesEnd = Clock::now();
+        row.AddGeometryTo(feature, levelOfDetail.precision);
+        attributes += attributesEnd - start;
+        geometries += Clock::now() - attributesEnd;
+    }
+};
+
+/**
+ * @brief Decode the copied rows, adds a "decode" span to the trace if there is one
+ */
+void DecodeRows(const std::pmr::vector<RawGeometry>& rows, BufferedFeatures& features, 
+    const LevelOfDetail& levelOfDetail, Trace* trace)
+{
+    features.reserve(rows.size());
+    if (trace == nullptr)
+    {
+        for (const auto& row : rows)
+        {
+            AddTo(row, features.emplace_back(row.GetId()), levelOfDetail);
+        }
+        return;
+    }
+
+    const auto start = Clock::now();
+    DecodeBreakdown breakdown;
+    for (const auto& row : rows)
+    {
+        breakdown.AddTo(row, features.emplace_back(row.GetId()), levelOfDetail);
+    }
+    trace->AddSpan("decode", start, Clock::now(), {
+        {"rows", rows.size()},
+        {"attributesUs", ToMicroseconds(breakdown.attributes)},
+        {"geometriesUs", ToMicroseconds(breakdown.geometries)}
+    });
+}
+
+struct RowBatch
+{
+    explicit RowBatch(std::pmr::memory_resource* resource) : rows{resource} {}
+
+    std::pmr::vector<RawGeometry> rows; /// Allocated from the arena of the request
+    BufferedFeatures features;
+    std::exception_ptr error;
+};
+
+/**
+ * @brief State shared by the request thread and the decode tasks. 
+ *  A task may start after the request is finished, so it's owned by all of them
+ */
+struct PipelineState
+{
+    boost::lockfree::queue<RowBatch*, boost::lockfree::capacity<QueueCapacity>> queue;
+    std::atomic<uint32_t> decodedBatches{0};
+    std::atomic<int64_t> decodeNanoseconds{0};
+    std::atomic<size_t> decodedVertices{0};  /// Only counted if the read is limited by the vertices
+    LevelOfDetail levelOfDetail;
+    Trace* trace = nullptr; /// Outlives the batches, since the request thread waits for all of them
+
+    /**
+     * @brief Decode the next batch from the queue
+     * 
+     * @param spent Incremented by the time spent on decoding
+     * @return false if the queue is empty
+     */
+    bool DecodeNext(std::chrono::nanoseconds& spent) noexcept
+    {
+        RowBatch* batch = nullptr;
+        if (!queue.pop(batch))
+            return false;
+
+        const auto start = Clock::now();
+        try
+        {
+            DecodeRows(batch->rows, batch->features, levelOfDetail, trace);
+            if (levelOfDetail.maxVertices != 0)
+                decodedVertices.fetch_add(CountVertices(batch->features), std::memory_order_relaxed);
+        }
+        catch (...)
+        {
+            batch->error = std::current_exception();
+        }
+        const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        spent += duration;
+        decodeNanoseconds.fetch_add(duration.count(), std::memory_order_relaxed);
+        // the batch may be destroyed by the request thread right after this
+        decodedBatches.fetch_add(1, std::memory_order_release);
+        decodedBatches.notify_all();
+        return true;
+    }
+};
+
+} // namespace
+
+DecodePipeline::DecodePipeline(const DecodePipelineOptions& options)
+    : m_options{options}
+{
+    if (m_options.threads > 0)
+    {
+        m_workers.emplace(m_options.threads);
+    }
+}
+
+[[nodiscard]] BufferedFeatures DecodePipeline::Decode(GeometriesView& geometries)
+{
+    DecodeStats stats;
+    return Decode(geometries, {}, stats);
+}
+
+[[nodiscard]] BufferedFeatures DecodePipeline::Decode(
+    GeometriesView& geometries, const LevelOfDetail& levelOfDetail, DecodeStats& stats)
+{
+    auto* const trace = Trace::Current();
+    const auto readStart = Clock::now();
+    BufferedFeatures result;
+    auto it = geometries.begin();
+    const auto end = geometries.end();
+    if (!m_workers.has_value())
+    {
+        DecodeBreakdown breakdown;
+        size_t vertices = 0;
+        for (; it != end; ++it)
+        {
+            if (levelOfDetail.IsReadLimitReached(result.size(), vertices))
+            {
+                stats.isReadTruncated = true;
+                break;
+            }
+            auto geometry = *it;
+            if (IsCulled(geometry, levelOfDetail))
+            {
+                ++stats.culledFeatures;
+                continue;
+            }
+            stats.blobBytes += geometry.GetBlobSize();
+            const auto start = Clock::now();
+            if (trace == nullptr)
+                AddTo(geometry, result.emplace_back(geometry.GetId()), levelOfDetail);
+            else
+                breakdown.AddTo(geometry, result.emplace_back(geometry.GetId()), levelOfDetail);
+            stats.decodeTime += Clock::now() - start;
+            vertices += result.back().GetPointsCount();
+        }
+        stats.requestThreadDecodeTime = stats.decodeTime;
+        if (trace != nullptr)
+        {
+            // rows are stepped and decoded one by one, so a single span holds the split of the time
+            const auto readEnd = Clock::now();
+            trace->AddSpan("step and decode", readStart, readEnd, {
+                {"rows", result.size()},
+                {"stepUs", ToMicroseconds(readEnd - readStart - stats.decodeTime)},
+                {"attributesUs", ToMicroseconds(breakdown.attributes)},
+                {"geometriesUs", ToMicroseconds(breakdown.geometries)}
+            });
+        }
+        return result;
+    }
+
+    // declared before the batches, since the rows must be destroyed first
+    const auto arena = AcquireDecodeArena();
+    auto* const resource = arena->GetResource();
+    // the vertices are only known once the workers decode the rows, so the read may overshoot by the batches in flight
+    size_t readRows = 0;
+    std::shared_ptr<PipelineState> state;
+    const auto readBatch = [&] {
+        ScopedSpan span{"step"};
+        auto batch = std::make_unique<RowBatch>(resource);
+        batch->rows.reserve(m_options.batchSize);
+        for (; it != end && batch->rows.size() < m_options.batchSize; ++it)
+        {
+            const auto vertices = state ? state->decodedVertices.load(std::memory_order_relaxed) : 0;
+            if (levelOfDetail.IsReadLimitReached(readRows, vertices))
+            {
+                stats.isReadTruncated = true;
+                break;
+            }
+            const auto geometry = *it;
+            if (IsCulled(geometry, levelOfDetail))
+            {
+                ++stats.culledFeatures;
+                continue;
+            }
+            stats.blobBytes += batch->rows.emplace_back(geometry.Copy(resource)).GetBlobSize();
+            ++readRows;
+        }
+        span.SetArg("rows", batch->rows.size());
+        return batch;
+    };
+
+    std::vector<std::unique_ptr<RowBatch>> batches;
+    batches.push_back(readBatch());
+    if (it != end && !stats.isReadTruncated)
+    {
+        // the tile is large enough to be worth decoding in parallel
+        state = std::make_shared<PipelineState>();
+        state->levelOfDetail = levelOfDetail;
+        state->trace = trace;
+
+        uint32_t pushed = 0;
+        // every batch gets a short decode task, so the workers are never blocked waiting for the rows of a request
+        const auto push = [this, &state, &pushed, &stats](RowBatch* batch) {
+            while (!state->queue.push(batch))
+            {
+                // the workers can't keep up, so the request thread helps them
+                state->DecodeNext(stats.requestThreadDecodeTime);
+            }
+            ++pushed;
+            // the task finds the queue empty if the request thread has decoded the batch already
+            boost::asio::post(*m_workers, [state] {
+                std::chrono::nanoseconds spent{0};
+                static_cast<void>(state->DecodeNext(spent));
+            });
+        };
+        // must be called even if reading fails, since the workers use the batches
+        const auto finish = [&state, &pushed, &stats] {
+            while (state->DecodeNext(stats.requestThreadDecodeTime)) {}
+            for (auto decoded = state->decodedBatches.load(std::memory_order_acquire); decoded != pushed;
+                 decoded = state->decodedBatches.load(std::memory_order_acquire))
+            {
+                state->decodedBatches.wait(decoded, std::memory_order_acquire);
+            }
+            stats.decodeTime = std::chrono::nanoseconds{state->decodeNanoseconds.load(std::memory_order_relaxed)};
+        };
+
+        try
+        {
+            push(batches.back().get());
+            while (it != end && !stats.isReadTruncated)
+            {
+                batches.push_back(readBatch());
+                push(batches.back().get());
+            }
+        }
+        catch (...)
+        {
+            finish();
+            throw;
+        }
+        finish();
+    }
+    else
+    {
+        const auto start = Clock::now();
+        DecodeRows(batches.back()->rows, batches.back()->features, levelOfDetail, trace);
+        stats.decodeTime = Clock::now() - start;
+        stats.requestThreadDecodeTime = stats.decodeTime;
+    }
+
+    stats.arenaBytes = arena->GetUsedBytes();
+    stats.arenaAllocations = arena->GetUpstreamAllocations();
+
+    size_t featuresCount = 0;
+    for (const auto& batch : batches)
+    {
+        if (batch->error)
+            std::rethrow_exception(batch->error);
+        featuresCount += batch->features.size();
+    }
+    result.reserve(featuresCount);
+    for (auto& batch : batches)
+    {
+        std::move(batch->features.begin(), batch->features.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "BufferedFeature.h"
+#include "ConfigLoader.h"
+#include "GeometriesView.h"
+#include "LevelOfDetail.h"
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Statistics of decoding a single view
+ */
+struct DecodeStats
+{
+    std::chrono::nanoseconds decodeTime{0};              /// Summed over all threads
+    std::chrono::nanoseconds requestThreadDecodeTime{0}; /// Part of the decode time spent in the calling thread
+    uint64_t blobBytes = 0;
+    uint64_t culledFeatures = 0;    /// Rows dropped by the level of detail before decoding
+    size_t arenaBytes = 0;          /// Scratch memory of the copied rows taken from the decode arena
+    uint64_t arenaAllocations = 0;  /// Allocator calls of the arena, zero once it's warmed up
+    bool isReadTruncated = false;   /// The read stopped at the limits of the level of detail
+};
+
+/**
+ * @brief Decodes geometries in worker threads while the request thread keeps stepping the statement.
+ *  Rows are copied in batches and passed to the workers through a bounded lock-free queue,
+ *  a decode task is posted for every batch, so the workers are shared by the requests without blocking,
+ *  the decoded features are returned in the order of the rows.
+ *  The copies are allocated from a per-request arena of the request thread, see DecodeArena
+ */
+class DecodePipeline
+{
+public:
+    explicit DecodePipeline(const DecodePipelineOptions& options);
+
+    /**
+     * @brief Read all geometries from the view and decode them
+     * 
+     * @param geometries Geometries to decode
+     * @return Decoded features in the order of the rows
+     */
+    [[nodiscard]] BufferedFeatures Decode(GeometriesView& geometries);
+
+    /**
+     * @brief Read all geometries from the view and decode the ones the level of detail keeps
+     * 
+     * @param geometries Geometries to decode
+     * @param levelOfDetail Simplifications of the features
+     * @param stats Decoding statistics
+     * @return Decoded features in the order of the rows
+     */
+    [[nodiscard]] BufferedFeatures Decode(GeometriesView& geometries, const LevelOfDetail& levelOfDetail, DecodeStats& stats);
+
+private:
+    const DecodePipelineOptions m_options;
+    std::optional<boost::asio::thread_pool> m_workers;
+};
+
+} // namespace SpatialiteDatasource
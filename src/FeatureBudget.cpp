@@ -0,0 +1,129 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "FeatureBudget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace SpatialiteDatasource {
+
+namespace {
+
+[[nodiscard]] double GetImportance(const BufferedFeature& feature, const LayerOptions& options, bool isPolygon)
+{
+    if (options.importance == FeatureImportance::Attribute)
+    {
+        const auto value = feature.GetNumericAttribute(options.importanceAttribute);
+        if (!value.has_value())
+        {
+            return -std::numeric_limits<double>::infinity();
+        }
+        return options.importanceAscending ? -*value : *value;
+    }
+    if (options.importance == FeatureImportance::Order)
+    {
+        // the ranking is stable, so equally important features stay in the query order
+        return 0.;
+    }
+
+    const auto mbr = feature.GetMbr();
+    if (!mbr.has_value())
+    {
+        return 0.;
+    }
+    const auto width = mbr->xmax - mbr->xmin;
+    const auto height = mbr->ymax - mbr->ymin;
+    return isPolygon ? width * height : std::hypot(width, height);
+}
+
+[[nodiscard]] size_t GetLimit(size_t budget) noexcept
+{
+    return budget != 0 ? budget : std::numeric_limits<size_t>::max();
+}
+
+} // namespace
+
+[[nodiscard]] std::optional<std::vector<const BufferedFeature*>> SelectFeaturesWithinBudget(
+    const std::vector<const BufferedFeature*>& features, const LayerOptions& options, GeometryType geometryType)
+{
+    if (options.maxFeatures == 0 && options.maxVertices == 0)
+    {
+        return std::nullopt;
+    }
+    const auto maxFeatures = GetLimit(options.maxFeatures);
+    const auto maxVertices = GetLimit(options.maxVertices);
+
+    size_t vertices = 0;
+    for (const auto* feature : features)
+    {
+        vertices += feature->GetPointsCount();
+    }
+    if (features.size() <= maxFeatures && vertices <= maxVertices)
+    {
+        return std::nullopt;
+    }
+
+    const auto isPolygon = geometryType == GeometryType::Polygon || geometryType == GeometryType::MultiPolygon;
+    std::vector<std::pair<double, size_t>> ranking; // importance and index of the feature
+    ranking.reserve(features.size());
+    for (size_t i = 0; i < features.size(); ++i)
+    {
+        ranking.emplace_back(GetImportance(*features[i], options, isPolygon), i);
+    }
+    // stable, so the features of equal importance are taken in the order of the query
+    std::ranges::stable_sort(ranking, std::greater{}, &std::pair<double, size_t>::first);
+
+    std::vector<bool> isSelected(features.size(), false);
+    size_t selectedCount = 0;
+    vertices = 0;
+    for (const auto& [importance, index] : ranking)
+    {
+        if (selectedCount == maxFeatures)
+        {
+            break;
+        }
+        const auto points = features[index]->GetPointsCount();
+        if (vertices + points > maxVertices)
+        {
+            continue;
+        }
+        vertices += points;
+        ++selectedCount;
+        isSelected[index] = true;
+    }
+
+    std::vector<const BufferedFeature*> selected;
+    selected.reserve(selectedCount);
+    for (size_t i = 0; i < features.size(); ++i)
+    {
+        if (isSelected[i])
+        {
+            selected.push_back(features[i]);
+        }
+    }
+    return selected;
+}
+
+} // namespace SpatialiteDatasource
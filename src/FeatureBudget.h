@@ -0,0 +1,45 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "BufferedFeature.h"
+#include "ConfigLoader.h"
+#include "GeometryType.h"
+
+#include <optional>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Select the most important features of a tile that fit the budget of the layer.
+ *  A feature that doesn't fit the vertices budget is skipped, so less important smaller features may still fit
+ * 
+ * @param features Features of the tile
+ * @param options Options of the layer with the budget and the importance of the features
+ * @param geometryType Geometry type of the layer, the size of polygons is their area and of other geometries the length
+ * @return Selected features in their original order or std::nullopt if all the features fit the budget
+ */
+[[nodiscard]] std::optional<std::vector<const BufferedFeature*>> SelectFeaturesWithinBudget(
+    const std::vector<const BufferedFeature*>& features, const LayerOptions& options, GeometryType geometryType);
+
+} // namespace SpatialiteDatasource
@@ -23,41 +23,86 @@
 #include "UniqueGaiaGeomCollPtr.h"
 
 #include <boost/algorithm/hex.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 
 namespace SpatialiteDatasource {
 
-static UniqueGaiaGeomCollPtr GetGaiaPtr(const SQLite::Statement& stmt)
+static UniqueGaiaGeomCollPtr GetGaiaPtr(const void* blob, int size)
 {
-    const auto geomColumn = stmt.getColumn("__geometry");
-    return UniqueGaiaGeomCollPtr{gaiaFromSpatiaLiteBlobWkb(static_cast<const uint8_t*>(geomColumn.getBlob()), geomColumn.size())};
+    return UniqueGaiaGeomCollPtr{gaiaFromSpatiaLiteBlobWkb(static_cast<const uint8_t*>(blob), size)};
+}
+
+/**
+ * @brief Buffer for the hex strings of blob attributes, they're only needed until added to the feature
+ */
+static std::string& GetHexBuffer()
+{
+    thread_local std::string hex;
+    return hex;
 }
 
-static std::string BlobToHex(const void* ptr, int size)
+[[nodiscard]] std::string BlobToHex(const void* ptr, int size)
 {
     std::string hex;
+    BlobToHex(ptr, size, hex);
+    return hex;
+}
+
+std::string_view BlobToHex(const void* ptr, int size, std::string& hex)
+{
+    hex.clear();
     hex.reserve(size * 2);
     const auto* blob = static_cast<const uint8_t*>(ptr);
     boost::algorithm::hex(blob, blob + size, std::back_inserter(hex));
     return hex;
 }
 
-Geometry::Geometry(const SQLite::Statement& stmt, const TableInfo& tableInfo) noexcept 
-    : m_stmt{stmt}
-    , m_tableInfo{tableInfo}
-{}
-
-[[nodiscard]] int Geometry::GetId() const
+[[nodiscard]] std::optional<Mbr> GetBlobMbr(const void* blob, int size) noexcept
 {
-    return m_stmt.getColumn("__id");
+    // START (0x00), endianness, SRID (int32), MBR (4 doubles), MBR_END (0x7C)
+    constexpr int MbrOffset = 6;
+    constexpr int MbrEndOffset = MbrOffset + 4 * sizeof(double);
+    constexpr uint8_t Start = 0x00;
+    constexpr uint8_t MbrEnd = 0x7C;
+    constexpr uint8_t LittleEndian = 0x01;
+    constexpr uint8_t BigEndian = 0x00;
+
+    const auto* bytes = static_cast<const uint8_t*>(blob);
+    if (size <= MbrEndOffset || bytes[0] != Start || bytes[MbrEndOffset] != MbrEnd || 
+        (bytes[1] != LittleEndian && bytes[1] != BigEndian))
+    {
+        return std::nullopt;
+    }
+
+    const auto isNativeOrder = (bytes[1] == LittleEndian) == (std::endian::native == std::endian::little);
+    double values[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        uint8_t valueBytes[sizeof(double)];
+        std::memcpy(valueBytes, bytes + MbrOffset + i * sizeof(double), sizeof(double));
+        if (!isNativeOrder)
+        {
+            std::reverse(std::begin(valueBytes), std::end(valueBytes));
+        }
+        std::memcpy(&values[i], valueBytes, sizeof(double));
+    }
+    return Mbr{values[0], values[1], values[2], values[3]};
 }
 
-void Geometry::AddTo(IFeature& feature)
-{
-    AddAttributesTo(feature);
+GeometryBlobDecoder::GeometryBlobDecoder(const TableInfo& tableInfo, const CoordinatePrecision& precision) noexcept
+    : m_tableInfo{tableInfo}
+    , m_precision{precision}
+{}
 
-    const auto geomPtr = GetGaiaPtr(m_stmt);
+void GeometryBlobDecoder::AddTo(const void* blob, int size, IFeature& feature) const
+{
+    const auto geomPtr = GetGaiaPtr(blob, size);
     switch (m_tableInfo.geometryType)
     {
     case GeometryType::Point:
@@ -81,67 +126,209 @@ void Geometry::AddTo(IFeature& feature)
     }
 }
 
-void Geometry::AddAttributesTo(IFeature& feature)
+void GeometryBlobDecoder::AddPointTo(gaiaPointPtr point, IFeature& feature) const
 {
-    for (const auto& [name, info] : m_tableInfo.attributes)
+    auto& geometry = feature.AddGeometry(m_tableInfo.geometryType, 1);
+    switch (m_tableInfo.dimension)
     {
-        const auto value = m_stmt.getColumn(name.c_str());
+    case Dimension::XY:
+    case Dimension::XYM:
+        geometry.AddPoint(MakePoint(point->X, point->Y)); 
+        break;
+    case Dimension::XYZ:
+    case Dimension::XYZM:
+        geometry.AddPoint(MakePoint(point->X, point->Y, point->Z));
+        break;
+    }
+}
+
+[[nodiscard]] mapget::Point GeometryBlobDecoder::MakePoint(double x, double y) const noexcept
+{
+    const auto& scaling = m_tableInfo.scaling;
+    x *= scaling.x;
+    y *= scaling.y;
+    if (m_precision.IsQuantized())
+    {
+        x = std::round(x / m_precision.gridSize) * m_precision.gridSize;
+        y = std::round(y / m_precision.gridSize) * m_precision.gridSize;
+    }
+    return {x, y};
+}
+
+[[nodiscard]] mapget::Point GeometryBlobDecoder::MakePoint(double x, double y, double z) const noexcept
+{
+    auto point = MakePoint(x, y);
+    if (!m_precision.dropZ)
+    {
+        point.z = z * m_tableInfo.scaling.z;
+    }
+    return point;
+}
+
+void GeometryBlobDecoder::AddMultiPointTo(gaiaPointPtr firstPoint, IFeature& feature) const
+{
+    for (auto* pointPtr = firstPoint; pointPtr != nullptr; pointPtr = pointPtr->Next)
+    {
+        AddPointTo(pointPtr, feature);
+    }
+}
+
+void GeometryBlobDecoder::AddMultiLineTo(gaiaLinestringPtr firstLine, IFeature& feature) const
+{
+    for (auto* linePtr = firstLine; linePtr != nullptr; linePtr = linePtr->Next)
+    {
+        AddLineOrPolygonTo(linePtr, feature);
+    }
+}
+
+void GeometryBlobDecoder::AddMultiPolygonTo(gaiaPolygonPtr firstPolygon, IFeature& feature) const
+{
+    for (auto* polygonPtr = firstPolygon; polygonPtr != nullptr; polygonPtr = polygonPtr->Next)
+    {
+        AddLineOrPolygonTo(polygonPtr->Exterior, feature);
+    }
+}
+
+RawGeometry::RawGeometry(const SQLite::Statement& stmt, const TableInfo& tableInfo, std::pmr::memory_resource* resource)
+    : m_tableInfo{&tableInfo}
+    , m_id{stmt.getColumn("__id")}
+    , m_blob{resource}
+    , m_attributes{resource}
+{
+    const auto geomColumn = stmt.getColumn("__geometry");
+    const auto* blob = static_cast<const uint8_t*>(geomColumn.getBlob());
+    m_blob.assign(blob, blob + geomColumn.size());
+
+    m_attributes.reserve(tableInfo.attributes.size());
+    for (const auto& [name, info] : tableInfo.attributes)
+    {
+        const auto value = stmt.getColumn(name.c_str());
         switch (info.type)
         {
         case ColumnType::Int64:
-            feature.AddAttribute(name, value.getInt64());
+            m_attributes.emplace_back(value.getInt64());
             break;
         case ColumnType::Double:
-            feature.AddAttribute(name, value.getDouble());
+            m_attributes.emplace_back(value.getDouble());
             break;
         case ColumnType::Text:
-            feature.AddAttribute(name, value.getString());
+            m_attributes.emplace_back(std::pmr::string{value.getText(), static_cast<size_t>(value.getBytes()), resource});
             break;
         case ColumnType::Blob:
-            feature.AddAttribute(name, BlobToHex(value.getBlob(), value.size()));
+            // hex conversion is a part of decoding, so only the bytes are copied here
+            m_attributes.emplace_back(std::pmr::string{
+                static_cast<const char*>(value.getBlob()), static_cast<size_t>(value.size()), resource});
             break;
         }
     }
 }
 
-void Geometry::AddPointTo(gaiaPointPtr point, IFeature& feature)
+[[nodiscard]] int RawGeometry::GetId() const noexcept
 {
-    auto geometry = feature.AddGeometry(m_tableInfo.geometryType, 1);
-    const auto& scaling = m_tableInfo.scaling;
-    switch (m_tableInfo.dimension)
-    {
-    case Dimension::XY:
-    case Dimension::XYM:
-        geometry->AddPoint({point->X * scaling.x, point->Y * scaling.y}); 
-        break;
-    case Dimension::XYZ:
-    case Dimension::XYZM:
-        geometry->AddPoint({point->X * scaling.x, point->Y * scaling.y, point->Z * scaling.z});
-        break;
-    }
+    return m_id;
 }
 
-void Geometry::AddMultiPointTo(gaiaPointPtr firstPoint, IFeature& feature)
+[[nodiscard]] size_t RawGeometry::GetBlobSize() const noexcept
 {
-    for (auto* pointPtr = firstPoint; pointPtr != nullptr; pointPtr = pointPtr->Next)
+    return m_blob.size();
+}
+
+void RawGeometry::AddTo(IFeature& feature, const CoordinatePrecision& precision) const
+{
+    AddAttributesTo(feature);
+    AddGeometryTo(feature, precision);
+}
+
+void RawGeometry::AddAttributesTo(IFeature& feature) const
+{
+    auto valueIt = m_attributes.begin();
+    for (const auto& [name, info] : m_tableInfo->attributes)
     {
-        AddPointTo(pointPtr, feature);
+        const auto& value = *valueIt++;
+        if (info.type == ColumnType::Blob)
+        {
+            const auto& bytes = std::get<std::pmr::string>(value);
+            feature.AddAttribute(name, BlobToHex(bytes.data(), static_cast<int>(bytes.size()), GetHexBuffer()));
+        }
+        else
+        {
+            std::visit([&feature, &name](const auto& v) { feature.AddAttribute(name, v); }, value);
+        }
     }
 }
 
-void Geometry::AddMultiLineTo(gaiaLinestringPtr firstLine, IFeature& feature)
+void RawGeometry::AddGeometryTo(IFeature& feature, const CoordinatePrecision& precision) const
 {
-    for (auto* linePtr = firstLine; linePtr != nullptr; linePtr = linePtr->Next)
+    GeometryBlobDecoder{*m_tableInfo, precision}.AddTo(m_blob.data(), static_cast<int>(m_blob.size()), feature);
+}
+
+Geometry::Geometry(const SQLite::Statement& stmt, const TableInfo& tableInfo) noexcept 
+    : m_stmt{stmt}
+    , m_tableInfo{tableInfo}
+{}
+
+[[nodiscard]] int Geometry::GetId() const
+{
+    return m_stmt.getColumn("__id");
+}
+
+[[nodiscard]] size_t Geometry::GetBlobSize() const
+{
+    return static_cast<size_t>(m_stmt.getColumn("__geometry").size());
+}
+
+[[nodiscard]] std::optional<Mbr> Geometry::GetMbr() const
+{
+    const auto geomColumn = m_stmt.getColumn("__geometry");
+    const auto mbr = GetBlobMbr(geomColumn.getBlob(), geomColumn.size());
+    if (!mbr.has_value())
     {
-        AddLineOrPolygonTo(linePtr, feature);
+        return std::nullopt;
     }
+    // scaling may flip the axes
+    const auto& scaling = m_tableInfo.scaling;
+    const auto [xmin, xmax] = std::minmax({mbr->xmin * scaling.x, mbr->xmax * scaling.x});
+    const auto [ymin, ymax] = std::minmax({mbr->ymin * scaling.y, mbr->ymax * scaling.y});
+    return Mbr{xmin, ymin, xmax, ymax};
 }
 
-void Geometry::AddMultiPolygonTo(gaiaPolygonPtr firstPolygon, IFeature& feature)
+void Geometry::AddTo(IFeature& feature, const CoordinatePrecision& precision)
 {
-    for (auto* polygonPtr = firstPolygon; polygonPtr != nullptr; polygonPtr = polygonPtr->Next)
+    AddAttributesTo(feature);
+    AddGeometryTo(feature, precision);
+}
+
+void Geometry::AddGeometryTo(IFeature& feature, const CoordinatePrecision& precision)
+{
+    const auto geomColumn = m_stmt.getColumn("__geometry");
+    GeometryBlobDecoder{m_tableInfo, precision}.AddTo(geomColumn.getBlob(), geomColumn.size(), feature);
+}
+
+[[nodiscard]] RawGeometry Geometry::Copy(std::pmr::memory_resource* resource) const
+{
+    return RawGeometry{m_stmt, m_tableInfo, resource};
+}
+
+void Geometry::AddAttributesTo(IFeature& feature)
+{
+    for (const auto& [name, info] : m_tableInfo.attributes)
     {
-        AddLineOrPolygonTo(polygonPtr->Exterior, feature);
+        const auto value = m_stmt.getColumn(name.c_str());
+        switch (info.type)
+        {
+        case ColumnType::Int64:
+            feature.AddAttribute(name, value.getInt64());
+            break;
+        case ColumnType::Double:
+            feature.AddAttribute(name, value.getDouble());
+            break;
+        case ColumnType::Text:
+            feature.AddAttribute(name, std::string_view{value.getText(), static_cast<size_t>(value.getBytes())});
+            break;
+        case ColumnType::Blob:
+            feature.AddAttribute(name, BlobToHex(value.getBlob(), value.size(), GetHexBuffer()));
+            break;
+        }
     }
 }
 
@@ -150,7 +337,7 @@ GeometryIterator::GeometryIterator(SQLite::Statement& stmt, const TableInfo& tab
     , m_tableInfo{&tableInfo}
 {}
 
-GeometryIterator& GeometryIterator::operator++() noexcept
+GeometryIterator& GeometryIterator::operator++()
 {
     if (!m_stmt->executeStep())
         m_stmt = nullptr;
@@ -184,4 +371,9 @@ GeometryIterator GeometriesView::end() const noexcept
     return {};
 }
 
+[[nodiscard]] std::string GeometriesView::GetExpandedSql() const
+{
+    return m_stmt.getExpandedSQL();
+}
+
 } // namespace SpatialiteDatasource
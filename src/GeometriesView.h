@@ -22,6 +22,7 @@
 
 #include "GeometryType.h"
 #include "IFeature.h"
+#include "Mbr.h"
 #include "TableInfo.h"
 
 #include <SQLiteCpp/Statement.h>
@@ -30,6 +31,15 @@
 #include <sqlite3.h>
 #include <spatialite.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
 namespace SpatialiteDatasource {
 namespace Detail {
 
@@ -38,60 +48,221 @@ concept LinelikeGeometryPtr = (std::same_as<T, gaiaLinestringPtr> || std::same_a
 
 } // namespace Detail
 
-class Geometry
+/**
+ * @brief Format the blob as an uppercase hex string, that's how blob attributes are added to features
+ * 
+ * @param ptr Blob data
+ * @param size Size of the blob in bytes
+ */
+[[nodiscard]] std::string BlobToHex(const void* ptr, int size);
+
+/**
+ * @brief Format the blob as an uppercase hex string into the given buffer, reusing its capacity
+ * 
+ * @param ptr Blob data
+ * @param size Size of the blob in bytes
+ * @param hex Buffer to overwrite with the hex string
+ * @return View of the buffer
+ */
+std::string_view BlobToHex(const void* ptr, int size, std::string& hex);
+
+/**
+ * @brief Read the MBR from the header of a spatialite geometry blob without decoding the geometry
+ * 
+ * @param blob Spatialite geometry blob
+ * @param size Size of the blob in bytes
+ * @return MBR or std::nullopt if the blob has no MBR in the header (e.g. a TinyPoint) or is invalid
+ */
+[[nodiscard]] std::optional<Mbr> GetBlobMbr(const void* blob, int size) noexcept;
+
+/**
+ * @brief Precision of the decoded coordinates, full precision by default
+ */
+struct CoordinatePrecision
+{
+    double gridSize = 0.; /// Scaled coordinates are rounded to the multiples of it, disabled if 0
+    bool dropZ = false;   /// Z of XYZ(M) tables is not added
+
+    [[nodiscard]] bool IsQuantized() const noexcept { return gridSize > 0.; }
+};
+
+/**
+ * @brief Decoder of spatialite geometry blobs
+ */
+class GeometryBlobDecoder
 {
 public:
-    Geometry(const SQLite::Statement& stmt, const TableInfo& tableInfo) noexcept;
+    explicit GeometryBlobDecoder(const TableInfo& tableInfo, const CoordinatePrecision& precision = {}) noexcept;
 
     /**
-     * @brief Get the id of the geometry (primary key)
+     * @brief Decode the blob and add the geometry to the given feature
      * 
-     * @return Geometry id
+     * @param blob Spatialite geometry blob
+     * @param size Size of the blob in bytes
+     * @param feature Feature to add the geometry to
      */
-    [[nodiscard]] int GetId() const;
+    void AddTo(const void* blob, int size, IFeature& feature) const;
+
+private:
+    void AddPointTo(gaiaPointPtr point, IFeature& feature) const;
+    void AddMultiPointTo(gaiaPointPtr firstPoint, IFeature& feature) const;
+    void AddMultiLineTo(gaiaLinestringPtr firstLine, IFeature& feature) const;
+    void AddMultiPolygonTo(gaiaPolygonPtr firstPolygon, IFeature& feature) const;
 
     /**
-     * @brief Add the geometry and it's attributes to the given feature
+     * @brief Scale the coordinates and apply the precision
      */
-    void AddTo(IFeature& feature);
-    
-private:
-    void AddAttributesTo(IFeature& feature);
-    void AddPointTo(gaiaPointPtr point, IFeature& feature);
-    void AddMultiPointTo(gaiaPointPtr firstPoint, IFeature& feature);
-    void AddMultiLineTo(gaiaLinestringPtr firstLine, IFeature& feature);
-    void AddMultiPolygonTo(gaiaPolygonPtr firstPolygon, IFeature& feature);
+    [[nodiscard]] mapget::Point MakePoint(double x, double y) const noexcept;
+    [[nodiscard]] mapget::Point MakePoint(double x, double y, double z) const noexcept;
 
     template <Detail::LinelikeGeometryPtr T>
-    void AddLineOrPolygonTo(T gaiaGeometry, IFeature& feature)
+    void AddLineOrPolygonTo(T gaiaGeometry, IFeature& feature) const
     {
-        auto geometry = feature.AddGeometry(m_tableInfo.geometryType, gaiaGeometry->Points);
-        const auto& scaling = m_tableInfo.scaling;
+        auto& geometry = feature.AddGeometry(m_tableInfo.geometryType, gaiaGeometry->Points);
+        mapget::Point previous;
+        int added = 0;
         for (int i = 0; i < gaiaGeometry->Points; ++i)
         {
             double x, y, z, m;
+            mapget::Point point;
             switch (m_tableInfo.dimension)
             {
             case Dimension::XY:
                 gaiaGetPoint(gaiaGeometry->Coords, i, &x, &y);
-                geometry->AddPoint({x * scaling.x, y * scaling.y}); 
+                point = MakePoint(x, y);
                 break;
             case Dimension::XYM:
                 gaiaGetPointXYM(gaiaGeometry->Coords, i, &x, &y, &m);
-                geometry->AddPoint({x * scaling.x, y * scaling.y}); 
+                point = MakePoint(x, y);
                 break;
             case Dimension::XYZ:
                 gaiaGetPointXYZ(gaiaGeometry->Coords, i, &x, &y, &z);
-                geometry->AddPoint({x * scaling.x, y * scaling.y, z * scaling.z});
+                point = MakePoint(x, y, z);
                 break;
             case Dimension::XYZM:
                 gaiaGetPointXYZM(gaiaGeometry->Coords, i, &x, &y, &z, &m);
-                geometry->AddPoint({x * scaling.x, y * scaling.y, z * scaling.z});
+                point = MakePoint(x, y, z);
                 break;
             }
+            // neighbouring vertices often fall into the same grid cell on low zoom levels
+            if (m_precision.IsQuantized() && i > 0 && 
+                point.x == previous.x && point.y == previous.y && point.z == previous.z)
+            {
+                continue;
+            }
+            geometry.AddPoint(point);
+            previous = point;
+            ++added;
+        }
+        // a line must keep 2 points and a ring 4, so a collapsed one is sent as a degenerate geometry.
+        // The last point of a ring is its first one, so repeating it keeps the ring closed
+        const auto isRing = m_tableInfo.geometryType == GeometryType::Polygon || 
+            m_tableInfo.geometryType == GeometryType::MultiPolygon;
+        for (const auto minPoints = std::min(isRing ? 4 : 2, gaiaGeometry->Points); added > 0 && added < minPoints; ++added)
+        {
+            geometry.AddPoint(previous);
         }
     }
 
+private:
+    const TableInfo& m_tableInfo;
+    const CoordinatePrecision m_precision;
+};
+
+/**
+ * @brief Geometry row copied from the statement, 
+ *  so it can be decoded after the statement has moved on (e.g. in another thread)
+ */
+class RawGeometry
+{
+public:
+    /**
+     * @param stmt Statement positioned at the row
+     * @param tableInfo Table of the row
+     * @param resource Memory resource for the copied blob and attributes, must outlive the row
+     */
+    RawGeometry(const SQLite::Statement& stmt, const TableInfo& tableInfo, std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Get the id of the geometry (primary key)
+     */
+    [[nodiscard]] int GetId() const noexcept;
+
+    /**
+     * @brief Get the size of the geometry blob in bytes
+     */
+    [[nodiscard]] size_t GetBlobSize() const noexcept;
+
+    /**
+     * @brief Add the geometry and it's attributes to the given feature
+     */
+    void AddTo(IFeature& feature, const CoordinatePrecision& precision = {}) const;
+
+    /**
+     * @brief Add only the attributes to the given feature
+     */
+    void AddAttributesTo(IFeature& feature) const;
+
+    /**
+     * @brief Add only the geometry to the given feature
+     */
+    void AddGeometryTo(IFeature& feature, const CoordinatePrecision& precision = {}) const;
+
+private:
+    using AttributeValue = std::variant<int64_t, double, std::pmr::string>;
+
+    const TableInfo* m_tableInfo;
+    int m_id;
+    std::pmr::vector<uint8_t> m_blob;
+    std::pmr::vector<AttributeValue> m_attributes; /// In the order of m_tableInfo->attributes
+};
+
+class Geometry
+{
+public:
+    Geometry(const SQLite::Statement& stmt, const TableInfo& tableInfo) noexcept;
+
+    /**
+     * @brief Get the id of the geometry (primary key)
+     * 
+     * @return Geometry id
+     */
+    [[nodiscard]] int GetId() const;
+
+    /**
+     * @brief Get the size of the geometry blob in bytes
+     */
+    [[nodiscard]] size_t GetBlobSize() const;
+
+    /**
+     * @brief Get the scaled MBR of the geometry from the blob header, the geometry isn't decoded
+     * 
+     * @return MBR or std::nullopt if the blob has no MBR in the header
+     */
+    [[nodiscard]] std::optional<Mbr> GetMbr() const;
+
+    /**
+     * @brief Add the geometry and it's attributes to the given feature
+     */
+    void AddTo(IFeature& feature, const CoordinatePrecision& precision = {});
+
+    /**
+     * @brief Add only the attributes to the given feature
+     */
+    void AddAttributesTo(IFeature& feature);
+
+    /**
+     * @brief Add only the geometry to the given feature
+     */
+    void AddGeometryTo(IFeature& feature, const CoordinatePrecision& precision = {});
+
+    /**
+     * @brief Copy the geometry row, so it can be decoded later
+     * 
+     * @param resource Memory resource for the copy, must outlive it
+     */
+    [[nodiscard]] RawGeometry Copy(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+    
 private:
     const SQLite::Statement& m_stmt;
     const TableInfo& m_tableInfo;
@@ -107,7 +278,10 @@ public:
         const TableInfo& tableInfo
     ) noexcept;
 
-    GeometryIterator& operator++() noexcept;
+    /**
+     * @brief Step to the next row, throws if the statement fails or is interrupted
+     */
+    GeometryIterator& operator++();
     [[nodiscard]] Geometry operator*() const noexcept;
     [[nodiscard]] bool operator==(const GeometryIterator& other) const noexcept;
 
@@ -130,6 +304,11 @@ public:
     GeometryIterator begin();
     GeometryIterator end() const noexcept;
 
+    /**
+     * @brief Get the SQL of the query with the bound parameters
+     */
+    [[nodiscard]] std::string GetExpandedSql() const;
+
 private:
     SQLite::Statement m_stmt;
     const TableInfo& m_tableInfo;
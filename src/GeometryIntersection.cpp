@@ -0,0 +1,138 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "GeometryIntersection.h"
+
+#include <cstdint>
+
+namespace SpatialiteDatasource {
+namespace {
+
+// Cohen-Sutherland outcodes: bits of the sides of the MBR the point lies beyond
+constexpr uint8_t Left = 1;
+constexpr uint8_t Right = 2;
+constexpr uint8_t Bottom = 4;
+constexpr uint8_t Top = 8;
+
+[[nodiscard]] uint8_t GetOutcode(const mapget::Point& point, const Mbr& mbr) noexcept
+{
+    // branchless, so the loops over the coordinates stay cheap
+    return static_cast<uint8_t>(
+        (point.x < mbr.xmin) * Left | (point.x > mbr.xmax) * Right |
+        (point.y < mbr.ymin) * Bottom | (point.y > mbr.ymax) * Top);
+}
+
+[[nodiscard]] double Cross(const mapget::Point& a, const mapget::Point& b, double x, double y) noexcept
+{
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+/**
+ * @brief Check whether the segment which ends are both outside the MBR, but not beyond the same side, crosses it
+ */
+[[nodiscard]] bool SegmentCrosses(const mapget::Point& a, const mapget::Point& b, const Mbr& mbr) noexcept
+{
+    // the bounding boxes overlap, so the segment misses the MBR only if all corners are on one side of its line
+    const auto c1 = Cross(a, b, mbr.xmin, mbr.ymin);
+    const auto c2 = Cross(a, b, mbr.xmax, mbr.ymin);
+    const auto c3 = Cross(a, b, mbr.xmax, mbr.ymax);
+    const auto c4 = Cross(a, b, mbr.xmin, mbr.ymax);
+    const auto allPositive = c1 > 0. && c2 > 0. && c3 > 0. && c4 > 0.;
+    const auto allNegative = c1 < 0. && c2 < 0. && c3 < 0. && c4 < 0.;
+    return !allPositive && !allNegative;
+}
+
+[[nodiscard]] bool SegmentIntersects(
+    const mapget::Point& a, uint8_t codeA, const mapget::Point& b, uint8_t codeB, const Mbr& mbr) noexcept
+{
+    if (codeA == 0 || codeB == 0)
+        return true;
+    // most segments are rejected here, because both ends are beyond the same side
+    if ((codeA & codeB) != 0)
+        return false;
+    return SegmentCrosses(a, b, mbr);
+}
+
+/**
+ * @brief Check whether the point is inside of the ring, using the even-odd rule
+ */
+[[nodiscard]] bool Contains(const std::vector<mapget::Point>& ring, double x, double y) noexcept
+{
+    bool inside = false;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+    {
+        const auto& a = ring[i];
+        const auto& b = ring[j];
+        if ((a.y > y) != (b.y > y) && x < (b.x - a.x) * (y - a.y) / (b.y - a.y) + a.x)
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+} // namespace
+
+[[nodiscard]] bool PointsIntersect(const std::vector<mapget::Point>& points, const Mbr& mbr) noexcept
+{
+    for (const auto& point : points)
+    {
+        if (GetOutcode(point, mbr) == 0)
+            return true;
+    }
+    return false;
+}
+
+[[nodiscard]] bool LineIntersects(const std::vector<mapget::Point>& points, const Mbr& mbr) noexcept
+{
+    if (points.empty())
+        return false;
+
+    auto previousCode = GetOutcode(points[0], mbr);
+    if (previousCode == 0)
+        return true;
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        const auto code = GetOutcode(points[i], mbr);
+        if (SegmentIntersects(points[i - 1], previousCode, points[i], code, mbr))
+            return true;
+        previousCode = code;
+    }
+    return false;
+}
+
+[[nodiscard]] bool PolygonIntersects(const std::vector<mapget::Point>& ring, const Mbr& mbr) noexcept
+{
+    if (ring.empty())
+        return false;
+
+    if (LineIntersects(ring, mbr))
+        return true;
+    const auto& first = ring.front();
+    const auto& last = ring.back();
+    if (SegmentIntersects(last, GetOutcode(last, mbr), first, GetOutcode(first, mbr), mbr))
+        return true;
+
+    // no edge touches the MBR, so it's either completely inside of the polygon or completely outside
+    return Contains(ring, (mbr.xmin + mbr.xmax) / 2., (mbr.ymin + mbr.ymax) / 2.);
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,50 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "Mbr.h"
+
+#include <mapget/model/point.h>
+
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Check whether any of the points lies within the MBR, borders included
+ */
+[[nodiscard]] bool PointsIntersect(const std::vector<mapget::Point>& points, const Mbr& mbr) noexcept;
+
+/**
+ * @brief Check whether the polyline crosses or touches the MBR
+ */
+[[nodiscard]] bool LineIntersects(const std::vector<mapget::Point>& points, const Mbr& mbr) noexcept;
+
+/**
+ * @brief Check whether the polygon crosses, touches, contains or is contained in the MBR
+ * 
+ * @param ring Outer ring of the polygon, the closing point may be omitted
+ * @param mbr Minimum bounding rectangle
+ */
+[[nodiscard]] bool PolygonIntersects(const std::vector<mapget::Point>& ring, const Mbr& mbr) noexcept;
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,210 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "HeavyTileSplitter.h"
+#include "Deadline.h"
+#include "Tracing.h"
+
+#include <mapget/log.h>
+#include <boost/asio/post.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+namespace {
+
+// Weight of the latest request in the features density estimate
+constexpr double DensitySmoothing = 0.2;
+
+[[nodiscard]] double Area(const Mbr& mbr) noexcept
+{
+    return (mbr.xmax - mbr.xmin) * (mbr.ymax - mbr.ymin);
+}
+
+/**
+ * @brief Concatenate features of the parts, features that intersect several parts are kept once
+ */
+[[nodiscard]] BufferedFeatures MergeParts(std::vector<BufferedFeatures>&& parts)
+{
+    size_t total = 0;
+    for (const auto& part : parts)
+    {
+        total += part.size();
+    }
+
+    BufferedFeatures features;
+    features.reserve(total);
+    std::unordered_set<int> ids;
+    ids.reserve(total);
+    for (auto& part : parts)
+    {
+        for (auto& feature : part)
+        {
+            if (ids.insert(feature.GetId()).second)
+            {
+                features.push_back(std::move(feature));
+            }
+        }
+    }
+    return features;
+}
+
+/**
+ * @brief Parts of a split read, claimed one by one by the workers and the calling thread.
+ *  Workers may start after the read is finished, so it's owned by all of them
+ */
+struct SplitRead
+{
+    explicit SplitRead(std::vector<Mbr>&& mbrParts)
+        : parts{std::move(mbrParts)}
+        , results(parts.size())
+        , errors(parts.size())
+    {}
+
+    const std::vector<Mbr> parts;
+    std::vector<BufferedFeatures> results;
+    std::vector<std::exception_ptr> errors;
+    std::atomic<size_t> nextPart{0};
+    std::atomic<size_t> readParts{0};
+
+    /**
+     * @brief Read the next part nobody has claimed yet
+     * 
+     * @return false if all the parts are claimed
+     */
+    bool ReadNext(const HeavyTileSplitter::ReadFunction& read, const TableInfo& tableInfo, uint16_t zoom) noexcept
+    {
+        const auto part = nextPart.fetch_add(1, std::memory_order_relaxed);
+        if (part >= parts.size())
+            return false;
+
+        try
+        {
+            results[part] = read(tableInfo, parts[part], zoom);
+        }
+        catch (...)
+        {
+            errors[part] = std::current_exception();
+        }
+        // the results may be taken by the calling thread right after this
+        readParts.fetch_add(1, std::memory_order_release);
+        readParts.notify_all();
+        return true;
+    }
+};
+
+} // namespace
+
+HeavyTileSplitter::HeavyTileSplitter(const HeavyTileOptions& options, size_t threads, ReadFunction read)
+    : m_options{options}
+    , m_read{std::move(read)}
+{
+    if (m_options.minFeatures != 0 && threads != 0)
+    {
+        m_workers.emplace(threads);
+    }
+}
+
+[[nodiscard]] BufferedFeatures HeavyTileSplitter::Read(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom)
+{
+    if (m_options.minFeatures == 0)
+    {
+        return m_read(tableInfo, mbr, zoom);
+    }
+
+    const auto estimate = EstimateFeatures(tableInfo.name, mbr);
+    auto features = estimate >= static_cast<double>(m_options.minFeatures) 
+        ? ReadSplit(tableInfo, mbr, zoom)
+        : m_read(tableInfo, mbr, zoom);
+    UpdateDensity(tableInfo.name, mbr, features.size());
+    return features;
+}
+
+[[nodiscard]] double HeavyTileSplitter::EstimateFeatures(const std::string& table, const Mbr& mbr) const
+{
+    std::lock_guard lock{m_mutex};
+    const auto it = m_densityByTable.find(table);
+    return it == m_densityByTable.end() ? 0. : it->second * Area(mbr);
+}
+
+[[nodiscard]] BufferedFeatures HeavyTileSplitter::ReadSplit(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom) const
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto read = std::make_shared<SplitRead>(Split(mbr, m_options.splitGrid));
+    const auto partsCount = read->parts.size();
+
+    if (m_workers.has_value())
+    {
+        auto* const trace = Trace::Current();
+        const auto* const deadline = Deadline::Current();
+        // the calling thread reads a part too, the other ones are offered to the workers
+        for (size_t i = 1; i < partsCount; ++i)
+        {
+            // the references are only used for a claimed part, and the calling thread waits for all of them
+            boost::asio::post(*m_workers, [this, read, trace, deadline, zoom, &tableInfo] {
+                TraceScope traceScope{trace};
+                DeadlineScope deadlineScope{deadline};
+                static_cast<void>(read->ReadNext(m_read, tableInfo, zoom));
+            });
+        }
+    }
+    while (read->ReadNext(m_read, tableInfo, zoom)) {}
+    for (auto readParts = read->readParts.load(std::memory_order_acquire); readParts != partsCount;
+         readParts = read->readParts.load(std::memory_order_acquire))
+    {
+        read->readParts.wait(readParts, std::memory_order_acquire);
+    }
+
+    for (const auto& error : read->errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+    auto features = MergeParts(std::move(read->results));
+    mapget::log().debug("Read {} features of table '{}' in {} parts within {}ms",
+        features.size(), tableInfo.name, partsCount, 
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    return features;
+}
+
+void HeavyTileSplitter::UpdateDensity(const std::string& table, const Mbr& mbr, size_t features)
+{
+    const auto area = Area(mbr);
+    if (area <= 0.)
+    {
+        return;
+    }
+
+    const auto density = static_cast<double>(features) / area;
+    std::lock_guard lock{m_mutex};
+    if (auto [it, isInserted] = m_densityByTable.emplace(table, density); !isInserted)
+    {
+        it->second += DensitySmoothing * (density - it->second);
+    }
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,91 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "BufferedFeature.h"
+#include "ConfigLoader.h"
+#include "Mbr.h"
+#include "TableInfo.h"
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Splits the MBR of a request that is expected to return many features into sub-rectangles,
+ *  reads them concurrently and merges the results.
+ *  The parts are read by a bounded pool of workers shared by all requests, the calling thread reads the parts
+ *  no worker has taken, so a request isn't delayed by a busy pool.
+ *  The number of features is estimated from the features density of the previous requests of the table
+ */
+class HeavyTileSplitter
+{
+public:
+    using ReadFunction = std::function<BufferedFeatures(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom)>;
+
+    /**
+     * @brief Construct a new Heavy Tile Splitter object
+     * 
+     * @param options Splitting options
+     * @param threads Number of the workers, e.g. the number of the database connections.
+     *  The parts are read by the calling thread only if 0
+     * @param read Function that reads and decodes features of the table within MBR, must be thread-safe
+     */
+    HeavyTileSplitter(const HeavyTileOptions& options, size_t threads, ReadFunction read);
+
+    /**
+     * @brief Read features of the table within MBR, concurrently by parts if there are many features expected
+     * 
+     * @param tableInfo Table which contains geometries
+     * @param mbr Minimum bounding rectangle
+     * @param zoom Zoom level of the requested tiles
+     */
+    [[nodiscard]] BufferedFeatures Read(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom);
+
+    /**
+     * @brief Get the expected number of features of the table within MBR
+     */
+    [[nodiscard]] double EstimateFeatures(const std::string& table, const Mbr& mbr) const;
+
+private:
+    [[nodiscard]] BufferedFeatures ReadSplit(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom) const;
+    void UpdateDensity(const std::string& table, const Mbr& mbr, size_t features);
+
+private:
+    const HeavyTileOptions m_options;
+    const ReadFunction m_read;
+    mutable std::optional<boost::asio::thread_pool> m_workers; /// Only created if splitting is enabled
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<
+        std::string, // table
+        double> m_densityByTable; /// Features per unit of area
+};
+
+} // namespace SpatialiteDatasource
@@ -52,9 +52,10 @@ struct IFeature
      * 
      * @param type Type of the geometry to add
      * @param initialCapacity Initial capacity (points) of the geometry
-     * @return Created geometry
+     * @return Created geometry, valid until the next geometry is added. It's owned by the feature,
+     *  so adding a geometry doesn't allocate a handle for it
      */
-    virtual std::unique_ptr<IGeometry> AddGeometry(GeometryType type, size_t initialCapacity) = 0;
+    virtual IGeometry& AddGeometry(GeometryType type, size_t initialCapacity) = 0;
 
     /**
      * @brief Add attribute to the feature
@@ -0,0 +1,65 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "LazyTableInfo.h"
+
+#include <mapget/log.h>
+
+#include <chrono>
+
+namespace SpatialiteDatasource {
+
+LazyTableInfo::LazyTableInfo(TableInfo tableInfo)
+    : m_isLoaded{true},
+      m_tableInfo{std::move(tableInfo)}
+{}
+
+LazyTableInfo::LazyTableInfo(LoadFunction load)
+    : m_isLoaded{false},
+      m_load{std::move(load)}
+{}
+
+[[nodiscard]] const TableInfo& LazyTableInfo::Get(DatabasePool& pool)
+{
+    std::call_once(m_loadOnce, [this, &pool] {
+        if (m_load)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            {
+                const auto connection = pool.Acquire();
+                m_tableInfo = m_load(*connection);
+            }
+            m_load = nullptr;
+            mapget::log().info("Loaded info of table '{}' in {}ms", m_tableInfo.name,
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+        static_cast<void>(m_tableInfo.GetSqlQuery());
+        m_isLoaded.store(true, std::memory_order_release);
+    });
+    return m_tableInfo;
+}
+
+[[nodiscard]] bool LazyTableInfo::IsLoaded() const noexcept
+{
+    return m_isLoaded.load(std::memory_order_acquire);
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,83 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "DatabasePool.h"
+#include "TableInfo.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Table info that may be loaded from the database on the first use
+ */
+class LazyTableInfo
+{
+public:
+    using LoadFunction = std::function<TableInfo(const Database& database)>;
+
+    /**
+     * @brief Construct already loaded table info
+     */
+    explicit LazyTableInfo(TableInfo tableInfo);
+
+    /**
+     * @brief Construct table info that's loaded on the first use
+     * 
+     * @param load Function that loads the table info
+     */
+    explicit LazyTableInfo(LoadFunction load);
+
+    LazyTableInfo(const LazyTableInfo&) = delete;
+    LazyTableInfo& operator=(const LazyTableInfo&) = delete;
+
+    /**
+     * @brief Get the table info, loading it on a connection from the pool if needed.
+     *  Thread-safe, the SQL query of the table is built here as well, 
+     *  so the returned table info can be shared by requests without synchronization.
+     *  If loading fails, it's retried on the next call
+     * 
+     * @param pool Pool of database connections
+     */
+    [[nodiscard]] const TableInfo& Get(DatabasePool& pool);
+
+    /**
+     * @brief Whether the table info is already loaded, thread-safe
+     */
+    [[nodiscard]] bool IsLoaded() const noexcept;
+
+private:
+    std::once_flag m_loadOnce;
+    std::atomic<bool> m_isLoaded;
+    LoadFunction m_load;
+    TableInfo m_tableInfo;
+};
+
+// table_name -> lazy_table_info
+using LazyTablesInfo = std::unordered_map<std::string, LazyTableInfo>;
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,84 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "LevelOfDetail.h"
+
+#include <cmath>
+
+namespace SpatialiteDatasource {
+
+[[nodiscard]] double GetPixelSize(uint16_t zoom) noexcept
+{
+    // there are 2 tiles of 180 degrees on zoom level 0, the number doubles along each axis with every level
+    return std::ldexp(180., -static_cast<int>(zoom)) / TileSizePixels;
+}
+
+[[nodiscard]] LevelOfDetail GetLevelOfDetail(const LayerOptions& options, const TableInfo& tableInfo, uint16_t zoom)
+{
+    LevelOfDetail levelOfDetail;
+    // points have no extent, culling them by size would drop all of them
+    const auto isPointLayer = tableInfo.geometryType == GeometryType::Point || tableInfo.geometryType == GeometryType::MultiPoint;
+    if (!isPointLayer)
+    {
+        levelOfDetail.minFeatureSize = options.subPixelCullingPixels * GetPixelSize(zoom);
+    }
+    if (zoom <= options.quantizationMaxZoom)
+    {
+        levelOfDetail.precision.gridSize = options.quantizationGridPixels * GetPixelSize(zoom);
+    }
+    levelOfDetail.precision.dropZ = zoom < options.dropZBelowZoom;
+    if (isPointLayer && zoom < options.clusterBelowZoom)
+    {
+        levelOfDetail.clusterCellSize = options.clusterCellPixels * GetPixelSize(zoom);
+    }
+    if (levelOfDetail.clusterCellSize > 0.)
+    {
+        // clusters are built from all the points of the tile and the budget doesn't apply to them
+        return levelOfDetail;
+    }
+    // features in the query order after the budget are dropped anyway, the importance needs more candidates
+    const auto readFactor = options.importance == FeatureImportance::Order ? 1 : ImportanceReadFactor;
+    levelOfDetail.maxRows = options.maxFeatures * readFactor;
+    levelOfDetail.maxVertices = options.maxVertices * readFactor;
+    return levelOfDetail;
+}
+
+[[nodiscard]] LevelOfDetail GetReadLevelOfDetail(
+    const LayerOptions& options, const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom)
+{
+    auto levelOfDetail = GetLevelOfDetail(options, tableInfo, zoom);
+    if (!IsTileMbr(mbr, zoom))
+    {
+        levelOfDetail.maxRows = 0;
+        levelOfDetail.maxVertices = 0;
+    }
+    return levelOfDetail;
+}
+
+[[nodiscard]] bool IsTileMbr(const Mbr& mbr, uint16_t zoom) noexcept
+{
+    const auto tileSize = GetPixelSize(zoom) * TileSizePixels;
+    // the MBR of a batch is a union of tiles, so it's either a single tile or at least two of them
+    const auto epsilon = tileSize * 1e-9;
+    return std::abs(mbr.xmax - mbr.xmin - tileSize) <= epsilon && std::abs(mbr.ymax - mbr.ymin - tileSize) <= epsilon;
+}
+
+} // namespace SpatialiteDatasource
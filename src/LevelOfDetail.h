@@ -0,0 +1,109 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "ConfigLoader.h"
+#include "GeometriesView.h"
+#include "Mbr.h"
+#include "TableInfo.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SpatialiteDatasource {
+
+/// Tiles are rendered with this many pixels per side
+constexpr double TileSizePixels = 256.;
+
+/**
+ * @brief Get the size of a pixel of the tiles of the zoom level in degrees
+ */
+[[nodiscard]] double GetPixelSize(uint16_t zoom) noexcept;
+
+/**
+ * @brief Simplifications of the features of a tile request, derived from the layer options and the tile zoom level
+ */
+struct LevelOfDetail
+{
+    double minFeatureSize = 0.; /// Features which MBR is smaller than this in both directions are culled, disabled if 0
+    CoordinatePrecision precision;
+    double clusterCellSize = 0.; /// Points are merged into clusters on a grid of this size, disabled if 0
+    size_t maxRows = 0;          /// The read stops after this many rows, unlimited if 0
+    size_t maxVertices = 0;      /// The read stops after this many decoded vertices, unlimited if 0
+
+    /**
+     * @brief Check whether a feature with the given MBR is too small to be sent
+     */
+    [[nodiscard]] bool IsCulled(const Mbr& mbr) const noexcept
+    {
+        return mbr.xmax - mbr.xmin < minFeatureSize && mbr.ymax - mbr.ymin < minFeatureSize;
+    }
+
+    /**
+     * @brief Check whether the attributes of the features are sent, clusters only have the count of their points
+     */
+    [[nodiscard]] bool NeedsAttributes() const noexcept
+    {
+        return clusterCellSize <= 0.;
+    }
+
+    /**
+     * @brief Check whether the read has to stop before the next row
+     */
+    [[nodiscard]] bool IsReadLimitReached(size_t rows, size_t vertices) const noexcept
+    {
+        return (maxRows != 0 && rows >= maxRows) || (maxVertices != 0 && vertices >= maxVertices);
+    }
+};
+
+/// The read of a tile stops at this many times its budget if the features are chosen by importance
+constexpr size_t ImportanceReadFactor = 4;
+
+/**
+ * @brief Get the simplifications of the table features for the tiles of the zoom level
+ * 
+ * @param options Options of the layer
+ * @param tableInfo Table of the layer
+ * @param zoom Zoom level of the tiles
+ */
+[[nodiscard]] LevelOfDetail GetLevelOfDetail(const LayerOptions& options, const TableInfo& tableInfo, uint16_t zoom);
+
+/**
+ * @brief Get the simplifications of the table features for a read of the MBR.
+ *  The read limits are per tile, so they only apply if the MBR is a single tile: a batched or split read
+ *  isn't stopped early, otherwise a dense tile would use up the limit of the other tiles of the read.
+ *  Such reads are trimmed per tile by the budget instead
+ * 
+ * @param options Options of the layer
+ * @param tableInfo Table of the layer
+ * @param mbr MBR of the read
+ * @param zoom Zoom level of the tiles
+ */
+[[nodiscard]] LevelOfDetail GetReadLevelOfDetail(
+    const LayerOptions& options, const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom);
+
+/**
+ * @brief Check whether the MBR has the size of a tile of the zoom level
+ */
+[[nodiscard]] bool IsTileMbr(const Mbr& mbr, uint16_t zoom) noexcept;
+
+} // namespace SpatialiteDatasource
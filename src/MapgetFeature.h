@@ -24,14 +24,14 @@
 
 #include <mapget/model/feature.h>
 
-#include <memory>
+#include <optional>
 
 namespace SpatialiteDatasource {
 
 class MapgetGeometry : public IGeometry
 {
 public:
-    explicit MapgetGeometry(mapget::model_ptr<mapget::Geometry>&& geometry) : m_geometry{std::move(geometry)} {}
+    explicit MapgetGeometry(mapget::model_ptr<mapget::Geometry>&& geometry) noexcept : m_geometry{std::move(geometry)} {}
     
     void AddPoint(const mapget::Point& point) final
     {
@@ -46,10 +46,9 @@ class MapgetFeature : public IFeature
 public:
     explicit MapgetFeature(mapget::Feature& feature) : m_feature{feature} {}
 
-    std::unique_ptr<IGeometry> AddGeometry(GeometryType type, size_t initialCapacity) final
+    IGeometry& AddGeometry(GeometryType type, size_t initialCapacity) final
     {
-        return std::make_unique<MapgetGeometry>(
-            m_feature.geom()->newGeometry(GeometryToMapgetGeometry(type), initialCapacity));
+        return m_geometry.emplace(m_feature.geom()->newGeometry(GeometryToMapgetGeometry(type), initialCapacity));
     }
 
     void AddAttribute(std::string_view name, int64_t value) final
@@ -85,6 +84,7 @@ private:
 
 private:
     mapget::Feature& m_feature;
+    std::optional<MapgetGeometry> m_geometry; /// The last added geometry
 };
 
 } // namespace SpatialiteDatasource
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Minimum bounding rectangle
+ */
+struct Mbr
+{
+    double xmin, ymin, xmax, ymax;
+};
+
+/**
+ * @brief Check whether two MBRs intersect, touching borders count as an intersection
+ */
+[[nodiscard]] constexpr bool Intersects(const Mbr& lhs, const Mbr& rhs) noexcept
+{
+    return lhs.xmin <= rhs.xmax && rhs.xmin <= lhs.xmax && lhs.ymin <= rhs.ymax && rhs.ymin <= lhs.ymax;
+}
+
+/**
+ * @brief Get the MBR that contains both given MBRs
+ */
+[[nodiscard]] constexpr Mbr Union(const Mbr& lhs, const Mbr& rhs) noexcept
+{
+    return {
+        .xmin = lhs.xmin < rhs.xmin ? lhs.xmin : rhs.xmin,
+        .ymin = lhs.ymin < rhs.ymin ? lhs.ymin : rhs.ymin,
+        .xmax = lhs.xmax > rhs.xmax ? lhs.xmax : rhs.xmax,
+        .ymax = lhs.ymax > rhs.ymax ? lhs.ymax : rhs.ymax
+    };
+}
+
+/**
+ * @brief Split the MBR into a grid of equal sub-rectangles
+ * 
+ * @param mbr MBR to split
+ * @param gridSize Number of sub-rectangles along each axis
+ */
+[[nodiscard]] inline std::vector<Mbr> Split(const Mbr& mbr, size_t gridSize)
+{
+    std::vector<Mbr> parts;
+    parts.reserve(gridSize * gridSize);
+    const auto width = (mbr.xmax - mbr.xmin) / static_cast<double>(gridSize);
+    const auto height = (mbr.ymax - mbr.ymin) / static_cast<double>(gridSize);
+    for (size_t row = 0; row < gridSize; ++row)
+    {
+        for (size_t column = 0; column < gridSize; ++column)
+        {
+            // The last row/column ends exactly at the MBR border regardless of rounding
+            parts.push_back({
+                .xmin = mbr.xmin + width * static_cast<double>(column),
+                .ymin = mbr.ymin + height * static_cast<double>(row),
+                .xmax = column + 1 == gridSize ? mbr.xmax : mbr.xmin + width * static_cast<double>(column + 1),
+                .ymax = row + 1 == gridSize ? mbr.ymax : mbr.ymin + height * static_cast<double>(row + 1)
+            });
+        }
+    }
+    return parts;
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,184 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Metrics.h"
+
+#include <fmt/format.h>
+
+#include <iterator>
+#include <utility>
+
+namespace SpatialiteDatasource {
+namespace {
+
+constexpr std::string_view Prefix = "spatialite_datasource_";
+
+void WriteHeader(std::string& out, std::string_view name, std::string_view type, std::string_view help)
+{
+    fmt::format_to(std::back_inserter(out), "# HELP {0}{1} {2}\n# TYPE {0}{1} {3}\n", Prefix, name, help, type);
+}
+
+void WriteCounter(std::string& out, std::string_view name, std::string_view help, uint64_t value)
+{
+    WriteHeader(out, name, "counter", help);
+    fmt::format_to(std::back_inserter(out), "{}{} {}\n", Prefix, name, value);
+}
+
+[[nodiscard]] std::string LayerLabel(const std::string& layer)
+{
+    std::string label = "layer=\"";
+    for (const auto c : layer)
+    {
+        if (c == '"' || c == '\\')
+            label += '\\';
+        label += c;
+    }
+    label += '"';
+    return label;
+}
+
+template <class GetValue>
+void WriteLayersSamples(std::string& out, const DatasourceMetrics& metrics, 
+    std::string_view name, std::string_view type, std::string_view help, GetValue&& getValue)
+{
+    WriteHeader(out, name, type, help);
+    for (const auto& [layer, layerMetrics] : metrics.layers)
+    {
+        fmt::format_to(std::back_inserter(out), "{}{}{{{}}} {}\n", Prefix, name, LayerLabel(layer), getValue(layerMetrics));
+    }
+}
+
+template <class GetValue>
+void WriteLayersCounter(
+    std::string& out, const DatasourceMetrics& metrics, std::string_view name, std::string_view help, GetValue&& getValue)
+{
+    WriteLayersSamples(out, metrics, name, "counter", help, std::forward<GetValue>(getValue));
+}
+
+template <class GetHistogram>
+void WriteLayersHistogram(
+    std::string& out, const DatasourceMetrics& metrics, std::string_view name, std::string_view help, GetHistogram&& getHistogram)
+{
+    WriteHeader(out, name, "histogram", help);
+    for (const auto& [layer, layerMetrics] : metrics.layers)
+    {
+        getHistogram(layerMetrics).Write(out, fmt::format("{}{}", Prefix, name), LayerLabel(layer));
+    }
+}
+
+} // namespace
+
+void LayerMetrics::ObserveDecodeArenaBytes(uint64_t bytes) noexcept
+{
+    auto current = decodeArenaHighWaterBytes.load(std::memory_order_relaxed);
+    while (current < bytes && !decodeArenaHighWaterBytes.compare_exchange_weak(current, bytes, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::Observe(std::chrono::nanoseconds duration) noexcept
+{
+    const auto seconds = std::chrono::duration<double>(duration).count();
+    size_t bucket = 0;
+    while (bucket < Buckets.size() && seconds > Buckets[bucket])
+    {
+        ++bucket;
+    }
+    m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_sumNanoseconds.fetch_add(static_cast<uint64_t>(duration.count()), std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Write(std::string& out, std::string_view name, std::string_view labels) const
+{
+    auto inserter = std::back_inserter(out);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < Buckets.size(); ++i)
+    {
+        cumulative += m_counts[i].load(std::memory_order_relaxed);
+        fmt::format_to(inserter, "{}_bucket{{{},le=\"{}\"}} {}\n", name, labels, Buckets[i], cumulative);
+    }
+    cumulative += m_counts.back().load(std::memory_order_relaxed);
+    fmt::format_to(inserter, "{}_bucket{{{},le=\"+Inf\"}} {}\n", name, labels, cumulative);
+    fmt::format_to(inserter, "{}_sum{{{}}} {}\n", name, labels, 
+        static_cast<double>(m_sumNanoseconds.load(std::memory_order_relaxed)) / 1e9);
+    fmt::format_to(inserter, "{}_count{{{}}} {}\n", name, labels, cumulative);
+}
+
+[[nodiscard]] std::string FormatMetrics(
+    const DatasourceMetrics& metrics,
+    const std::unordered_map<std::string, size_t>& locatableFeatures,
+    const PageCacheStatus& pageCache)
+{
+    std::string out;
+    WriteCounter(out, "tile_requests_total", "Tile requests per feature type", metrics.tileRequests.load());
+    WriteCounter(out, "coalesced_tile_requests_total", "Tile requests served by an identical in-flight request",
+        metrics.coalescedTileRequests.load());
+    WriteCounter(out, "retried_tile_reads_total", "Tile reads retried after a shared read ran out of the time of another request",
+        metrics.retriedTileReads.load());
+    WriteCounter(out, "locate_hits_total", "Locate requests of known features", metrics.locateHits.load());
+    WriteCounter(out, "locate_misses_total", "Locate requests of unknown features", metrics.locateMisses.load());
+
+    WriteLayersHistogram(out, metrics, "query_seconds", "Time of preparing and stepping the tile statement",
+        [](const LayerMetrics& layer) -> const auto& { return layer.queryLatency; });
+    WriteLayersHistogram(out, metrics, "decode_seconds", "Time of decoding the tile rows",
+        [](const LayerMetrics& layer) -> const auto& { return layer.decodeLatency; });
+    WriteLayersHistogram(out, metrics, "append_seconds", "Time of adding the tile features to mapget",
+        [](const LayerMetrics& layer) -> const auto& { return layer.appendLatency; });
+    WriteLayersCounter(out, metrics, "rows_total", "Rows returned by tile statements",
+        [](const LayerMetrics& layer) { return layer.rows.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "culled_features_total", "Sub-pixel features skipped without decoding",
+        [](const LayerMetrics& layer) { return layer.culledFeatures.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "intersection_rejected_features_total", "Features dropped by the exact intersection test",
+        [](const LayerMetrics& layer) { return layer.intersectionRejectedFeatures.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "budget_dropped_features_total", "Features dropped as above the budget of a tile",
+        [](const LayerMetrics& layer) { return layer.budgetDroppedFeatures.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "truncated_tiles_total", "Tiles truncated to the budget",
+        [](const LayerMetrics& layer) { return layer.truncatedTiles.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "truncated_reads_total", "Reads stopped at the budget before the last row",
+        [](const LayerMetrics& layer) { return layer.truncatedReads.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "interrupted_queries_total", "Queries interrupted by the tile request deadline",
+        [](const LayerMetrics& layer) { return layer.interruptedQueries.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "vertices_total", "Vertices added to tiles",
+        [](const LayerMetrics& layer) { return layer.vertices.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "clusters_total", "Cluster features added to tiles instead of the points",
+        [](const LayerMetrics& layer) { return layer.clusters.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "blob_bytes_total", "Bytes of decoded geometry blobs",
+        [](const LayerMetrics& layer) { return layer.blobBytes.load(std::memory_order_relaxed); });
+    WriteLayersCounter(out, metrics, "decode_arena_allocations_total", "Allocator calls of the decode arenas, zero once they're warmed up",
+        [](const LayerMetrics& layer) { return layer.decodeArenaAllocations.load(std::memory_order_relaxed); });
+    WriteLayersSamples(out, metrics, "decode_arena_high_water_bytes", "gauge", "Largest decode scratch memory of a single read",
+        [](const LayerMetrics& layer) { return layer.decodeArenaHighWaterBytes.load(std::memory_order_relaxed); });
+
+    WriteHeader(out, "locatable_features", "gauge", "Features remembered for locate requests");
+    for (const auto& [layer, count] : locatableFeatures)
+    {
+        fmt::format_to(std::back_inserter(out), "{}locatable_features{{{}}} {}\n", Prefix, LayerLabel(layer), count);
+    }
+
+    WriteHeader(out, "page_cache_used_bytes", "gauge", "Memory used by SQLite page caches of all connections");
+    fmt::format_to(std::back_inserter(out), "{}page_cache_used_bytes {}\n", Prefix, pageCache.usedBytes);
+    // the statuses are cumulative since the connections were opened
+    WriteCounter(out, "page_cache_hits_total", "SQLite page cache hits of all connections", 
+        static_cast<uint64_t>(pageCache.hits));
+    WriteCounter(out, "page_cache_misses_total", "SQLite page cache misses of all connections", 
+        static_cast<uint64_t>(pageCache.misses));
+    return out;
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,127 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Lock-free histogram of durations in Prometheus format
+ */
+class LatencyHistogram
+{
+public:
+    /// Upper bounds of the buckets in seconds
+    static constexpr std::array<double, 14> Buckets{
+        0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1., 2.5, 5., 10., 30.};
+
+    /**
+     * @brief Add a duration to the histogram
+     */
+    void Observe(std::chrono::nanoseconds duration) noexcept;
+
+    /**
+     * @brief Append the histogram samples in Prometheus text format
+     * 
+     * @param out Output string
+     * @param name Metric name
+     * @param labels Labels of the samples without braces, e.g. 'layer="roads"'
+     */
+    void Write(std::string& out, std::string_view name, std::string_view labels) const;
+
+private:
+    std::array<std::atomic<uint64_t>, Buckets.size() + 1> m_counts{}; /// Not cumulative, the last one is +Inf
+    std::atomic<uint64_t> m_sumNanoseconds{0};
+};
+
+/**
+ * @brief Counters of a single layer (table)
+ */
+struct LayerMetrics
+{
+    LatencyHistogram queryLatency;   /// Preparing and stepping the statement of a read
+    LatencyHistogram decodeLatency;  /// Decoding rows of a read, summed over all decode threads
+    LatencyHistogram appendLatency;  /// Adding decoded features of a tile to mapget
+    std::atomic<uint64_t> rows{0};
+    std::atomic<uint64_t> culledFeatures{0}; /// Rows skipped before decoding as smaller than the level of detail
+    std::atomic<uint64_t> intersectionRejectedFeatures{0}; /// Features which MBR intersects the tile, but the geometry doesn't
+    std::atomic<uint64_t> budgetDroppedFeatures{0}; /// Features above the budget of a tile
+    std::atomic<uint64_t> truncatedTiles{0};        /// Tiles with features above the budget
+    std::atomic<uint64_t> truncatedReads{0};        /// Reads stopped at the budget before the last row
+    std::atomic<uint64_t> interruptedQueries{0};    /// Queries interrupted by the tile request deadline
+    std::atomic<uint64_t> vertices{0};
+    std::atomic<uint64_t> clusters{0};              /// Cluster features sent instead of the points
+    std::atomic<uint64_t> blobBytes{0};
+    std::atomic<uint64_t> decodeArenaAllocations{0};   /// Allocator calls of the decode arenas
+    std::atomic<uint64_t> decodeArenaHighWaterBytes{0}; /// Largest scratch memory of a single read
+
+    /**
+     * @brief Raise the high-water mark of the decode arena scratch memory
+     */
+    void ObserveDecodeArenaBytes(uint64_t bytes) noexcept;
+};
+
+/**
+ * @brief Datasource counters, safe to update from any request thread
+ */
+struct DatasourceMetrics
+{
+    std::atomic<uint64_t> tileRequests{0};          /// Tile requests per feature type
+    std::atomic<uint64_t> coalescedTileRequests{0}; /// Requests served by an identical in-flight request
+    std::atomic<uint64_t> retriedTileReads{0};      /// Reads retried after a shared read ran out of the time of another request
+    std::atomic<uint64_t> locateHits{0};
+    std::atomic<uint64_t> locateMisses{0};
+
+    /// Filled on startup for every table, so it can be read without locks
+    std::unordered_map<std::string /* table */, LayerMetrics> layers;
+};
+
+/**
+ * @brief SQLite page cache statistics of all connections
+ */
+struct PageCacheStatus
+{
+    int64_t usedBytes = 0;
+    int64_t hits = 0;
+    int64_t misses = 0;
+};
+
+/**
+ * @brief Format the metrics in Prometheus text exposition format
+ * 
+ * @param metrics Datasource counters
+ * @param locatableFeatures Number of features remembered for '/locate' requests by table
+ * @param pageCache SQLite page cache statistics
+ */
+[[nodiscard]] std::string FormatMetrics(
+    const DatasourceMetrics& metrics,
+    const std::unordered_map<std::string, size_t>& locatableFeatures,
+    const PageCacheStatus& pageCache);
+
+} // namespace SpatialiteDatasource
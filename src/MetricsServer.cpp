@@ -0,0 +1,57 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "MetricsServer.h"
+
+#include <mapget/log.h>
+#include <httplib.h>
+#include <fmt/format.h>
+
+#include <stdexcept>
+
+namespace SpatialiteDatasource {
+
+MetricsServer::MetricsServer(
+    const std::string& host, uint16_t port, CollectFunction collect, CollectFunction dumpSlowQueries)
+    : m_server{std::make_unique<httplib::Server>()}
+{
+    m_server->Get("/metrics", [collect = std::move(collect)](const httplib::Request&, httplib::Response& response) {
+        response.set_content(collect(), "text/plain; version=0.0.4");
+    });
+    m_server->Get("/slow-queries", 
+        [dump = std::move(dumpSlowQueries)](const httplib::Request&, httplib::Response& response) {
+            response.set_content(dump(), "application/json");
+        });
+    // Bound before the thread starts, so stop() in the destructor can't miss the listening socket
+    if (!m_server->bind_to_port(host, port))
+    {
+        throw std::runtime_error{fmt::format("Failed to start metrics server on {}:{}", host, port)};
+    }
+    m_thread = std::jthread{[this] { m_server->listen_after_bind(); }};
+    mapget::log().info("Metrics are available on {}:{} at '/metrics'", host, port);
+}
+
+MetricsServer::~MetricsServer()
+{
+    m_server->stop();
+}
+
+} // namespace SpatialiteDatasource
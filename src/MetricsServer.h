@@ -0,0 +1,68 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace httplib {
+class Server;
+}
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Admin HTTP server on a separate port that exposes '/metrics' in Prometheus text format
+ *  and '/slow-queries' as JSON
+ */
+class MetricsServer
+{
+public:
+    using CollectFunction = std::function<std::string()>;
+
+    /**
+     * @brief Start the server in a background thread
+     * 
+     * @param host Address to bind to
+     * @param port Port to listen on
+     * @param collect Function that formats the metrics, called for every scrape
+     * @param dumpSlowQueries Function that formats the slow query log
+     */
+    MetricsServer(const std::string& host, uint16_t port, CollectFunction collect, CollectFunction dumpSlowQueries);
+
+    /**
+     * @brief Stop the server and wait for the background thread
+     */
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+private:
+    std::unique_ptr<httplib::Server> m_server;
+    std::jthread m_thread;
+};
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,76 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "PointClustering.h"
+
+#include <boost/container_hash/hash.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace SpatialiteDatasource {
+namespace {
+
+[[nodiscard]] uint64_t PackCell(int32_t column, int32_t row) noexcept
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32 | static_cast<uint32_t>(row);
+}
+
+} // namespace
+
+[[nodiscard]] int GetClusterId(uint64_t tileId, uint64_t cell) noexcept
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, tileId);
+    boost::hash_combine(seed, cell);
+    return -static_cast<int>(seed % std::numeric_limits<int>::max()) - 1;
+}
+
+PointClusterGrid::PointClusterGrid(double cellSize) noexcept
+    : m_cellSize{cellSize}
+{}
+
+void PointClusterGrid::Add(const mapget::Point& point)
+{
+    const auto column = static_cast<int32_t>(std::floor(point.x / m_cellSize));
+    const auto row = static_cast<int32_t>(std::floor(point.y / m_cellSize));
+    const auto key = PackCell(column, row);
+    const auto [it, isNew] = m_cellIndices.try_emplace(key, static_cast<uint32_t>(m_cells.size()));
+    auto& cell = isNew ? m_cells.emplace_back(Cell{.key = key}) : m_cells[it->second];
+    cell.sumX += point.x;
+    cell.sumY += point.y;
+    ++cell.count;
+    ++m_points;
+}
+
+[[nodiscard]] std::vector<PointCluster> PointClusterGrid::GetClusters() const
+{
+    std::vector<PointCluster> clusters;
+    clusters.reserve(m_cells.size());
+    for (const auto& cell : m_cells)
+    {
+        const auto count = static_cast<double>(cell.count);
+        clusters.push_back({{cell.sumX / count, cell.sumY / count}, cell.count, cell.key});
+    }
+    return clusters;
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,95 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "IFeature.h"
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Points of a single grid cell merged into one
+ */
+struct PointCluster
+{
+    mapget::Point center; /// Mean of the clustered points
+    size_t count = 0;
+    uint64_t cell = 0;    /// Packed column and row of the cell
+};
+
+/**
+ * @brief Get the feature id of a cluster, it's the same in every response of the tile.
+ *  The ids are negative, so they don't clash with the positive rowids of the points
+ * 
+ * @param tileId Tile of the cluster
+ * @param cell Cell of the cluster in the grid of the tile
+ */
+[[nodiscard]] int GetClusterId(uint64_t tileId, uint64_t cell) noexcept;
+
+/**
+ * @brief Bins points into a grid of square cells in a single pass, 
+ *  only the count and the coordinates sum of the occupied cells are kept
+ */
+class PointClusterGrid
+{
+public:
+    /**
+     * @param cellSize Size of a cell in the units of the coordinates, the grid starts at 0
+     */
+    explicit PointClusterGrid(double cellSize) noexcept;
+
+    /**
+     * @brief Add the point to the cluster of its cell
+     */
+    void Add(const mapget::Point& point);
+
+    /**
+     * @brief Get the clusters of the occupied cells in the order the cells were first hit
+     */
+    [[nodiscard]] std::vector<PointCluster> GetClusters() const;
+
+    /**
+     * @brief Get the number of added points
+     */
+    [[nodiscard]] size_t GetPointsCount() const noexcept { return m_points; }
+
+private:
+    struct Cell
+    {
+        double sumX = 0.;
+        double sumY = 0.;
+        size_t count = 0;
+        uint64_t key = 0;
+    };
+
+    const double m_cellSize;
+    boost::unordered_flat_map<uint64_t, uint32_t> m_cellIndices; /// Packed cell coordinates to the index in m_cells
+    std::vector<Cell> m_cells;
+    size_t m_points = 0;
+};
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,261 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "PyramidBuilder.h"
+#include "Database.h"
+#include "LevelOfDetail.h"
+
+#include <mapget/log.h>
+#include <SQLiteCpp/Database.h>
+#include <SQLiteCpp/Statement.h>
+#include <SQLiteCpp/Transaction.h>
+#include <sqlite3.h>
+#include <spatialite.h>
+#include <fmt/format.h>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/join.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/scope_exit.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <stdexcept>
+
+namespace SpatialiteDatasource {
+
+namespace {
+
+/**
+ * @brief Layer table of the attached map database
+ */
+struct SourceTable
+{
+    std::string name;
+    std::string primaryKey;     /// Empty if the ids are the 'id' column, it's copied with the other columns
+    std::string primaryKeyType;
+    std::string geometryColumn;
+    int geometryType = 0; /// Spatialite geometry type, with the dimension in thousands
+    int srid = 0;
+    std::vector<std::pair<std::string, std::string>> columns; /// Names and declared types of the other columns
+};
+
+[[nodiscard]] SourceTable ReadSourceTable(const SQLite::Database& db, const std::string& table)
+{
+    SourceTable source;
+    source.name = table;
+
+    SQLite::Statement geometryStmt{db, fmt::format(R"SQL(
+        SELECT f_geometry_column, geometry_type, srid FROM {}.geometry_columns WHERE f_table_name = ?;
+    )SQL", AttachedSchemaName)};
+    geometryStmt.bind(1, table);
+    if (!geometryStmt.executeStep())
+    {
+        throw std::runtime_error{fmt::format("Table '{}' has no geometry column", table)};
+    }
+    source.geometryColumn = geometryStmt.getColumn(0).getString();
+    source.geometryType = geometryStmt.getColumn(1).getInt();
+    source.srid = geometryStmt.getColumn(2).getInt();
+    CheckSrid(table, source.srid);
+    const auto geometryType = static_cast<GeometryType>(source.geometryType % 1000);
+    if (geometryType == GeometryType::Point || geometryType == GeometryType::MultiPoint)
+    {
+        throw std::runtime_error{fmt::format("Table '{}' has points, they can't be simplified", table)};
+    }
+
+    SQLite::Statement columnsStmt{db, R"SQL(
+        SELECT name, type, pk FROM pragma_table_info(?, ?);
+    )SQL"};
+    columnsStmt.bind(1, table);
+    columnsStmt.bind(2, std::string{AttachedSchemaName});
+    while (columnsStmt.executeStep())
+    {
+        auto name = columnsStmt.getColumn(0).getString();
+        auto type = columnsStmt.getColumn(1).getString();
+        const auto pk = columnsStmt.getColumn(2).getInt();
+        if (pk > 1)
+        {
+            throw std::runtime_error{fmt::format("Table '{}' has a composite primary key", table)};
+        }
+        if (pk == 1)
+        {
+            source.primaryKey = std::move(name);
+            source.primaryKeyType = std::move(type);
+        }
+        else if (!boost::iequals(name, source.geometryColumn))
+        {
+            source.columns.emplace_back(std::move(name), std::move(type));
+        }
+    }
+    // the datasource reads the ids of a table without a primary key from its 'id' column or the rowid,
+    // the rowid isn't copied implicitly, so it becomes the key of the levels
+    const auto hasIdColumn = std::ranges::any_of(source.columns, [](const auto& column) { 
+        return boost::iequals(column.first, "id"); 
+    });
+    if (source.primaryKey.empty() && !hasIdColumn)
+    {
+        mapget::log().warn("Table '{}' has no primary key, the pyramid levels are keyed by its rowid", table);
+        source.primaryKey = "rowid";
+        source.primaryKeyType = "INTEGER";
+    }
+    return source;
+}
+
+[[nodiscard]] std::string GetColumnsList(const SourceTable& source)
+{
+    std::vector<std::string> columns;
+    if (!source.primaryKey.empty())
+    {
+        columns.push_back(fmt::format("\"{}\"", source.primaryKey));
+    }
+    for (const auto& [name, type] : source.columns)
+    {
+        columns.push_back(fmt::format("\"{}\"", name));
+    }
+    return boost::join(columns, ", ");
+}
+
+void CreateLevelTable(SQLite::Database& db, const SourceTable& source, const std::string& levelTable)
+{
+    std::vector<std::string> definitions;
+    if (!source.primaryKey.empty())
+    {
+        definitions.push_back(fmt::format("\"{}\" {} PRIMARY KEY", source.primaryKey, source.primaryKeyType));
+    }
+    for (const auto& [name, type] : source.columns)
+    {
+        definitions.push_back(fmt::format("\"{}\" {}", name, type));
+    }
+    db.exec(fmt::format("CREATE TABLE \"{}\" ({});", levelTable, boost::join(definitions, ", ")));
+
+    // index is the spatialite geometry type without the dimension
+    static constexpr std::array<const char*, 7> GeometryTypeNames{
+        "GEOMETRY", "POINT", "LINESTRING", "POLYGON", "MULTIPOINT", "MULTILINESTRING", "MULTIPOLYGON"};
+    static constexpr std::array<const char*, 4> DimensionNames{"XY", "XYZ", "XYM", "XYZM"};
+    SQLite::Statement stmt{db, "SELECT AddGeometryColumn(?, ?, ?, ?, ?);"};
+    stmt.bind(1, levelTable);
+    stmt.bind(2, source.geometryColumn);
+    stmt.bind(3, source.srid);
+    stmt.bind(4, GeometryTypeNames.at(source.geometryType % 1000));
+    stmt.bind(5, DimensionNames.at(source.geometryType / 1000));
+    if (!stmt.executeStep() || stmt.getColumn(0).getInt() != 1)
+    {
+        throw std::runtime_error{fmt::format("Can't add geometry column to '{}'", levelTable)};
+    }
+}
+
+/**
+ * @brief Copy the rows with simplified geometries, the rows which geometries collapse are dropped
+ * 
+ * @return Number of the copied rows
+ */
+[[nodiscard]] int FillLevelTable(SQLite::Database& db, const SourceTable& source, 
+    const std::string& from, const std::string& levelTable, double tolerance)
+{
+    SQLite::Statement stmt{db, fmt::format(R"SQL(
+        INSERT INTO "{0}" ({1}, "{2}")
+        SELECT {1}, simplified FROM (
+            SELECT {1}, SimplifyPreserveTopology("{2}", ?) AS simplified FROM {3}
+        ) WHERE simplified IS NOT NULL;
+    )SQL", levelTable, GetColumnsList(source), source.geometryColumn, from)};
+    stmt.bind(1, tolerance);
+    return stmt.exec();
+}
+
+void CreateSpatialIndex(SQLite::Database& db, const std::string& table, const std::string& geometryColumn)
+{
+    SQLite::Statement stmt{db, "SELECT CreateSpatialIndex(?, ?);"};
+    stmt.bind(1, table);
+    stmt.bind(2, geometryColumn);
+    if (!stmt.executeStep() || stmt.getColumn(0).getInt() != 1)
+    {
+        throw std::runtime_error{fmt::format("Can't create spatial index of '{}'", table)};
+    }
+}
+
+} // namespace
+
+[[nodiscard]] std::string GetPyramidLevelTableName(const std::string& table, uint16_t maxZoom)
+{
+    return fmt::format("{}_z{}", table, maxZoom);
+}
+
+void BuildPyramid(const PyramidBuildOptions& options)
+{
+    if (options.tables.empty() || options.maxZooms.empty())
+    {
+        throw std::runtime_error{"Pyramid needs at least one table and one zoom level"};
+    }
+    auto maxZooms = options.maxZooms;
+    std::ranges::sort(maxZooms, std::greater{});
+    maxZooms.erase(std::ranges::unique(maxZooms).begin(), maxZooms.end());
+
+    // the pyramid is built next to the target, so a failed build doesn't replace a working one
+    auto tmpPath = options.pyramidPath;
+    tmpPath += ".tmp";
+    std::filesystem::remove(tmpPath);
+    {
+        SQLite::Database db{tmpPath, SQLite::OPEN_CREATE | SQLite::OPEN_READWRITE};
+        auto* spatialiteCache = spatialite_alloc_connection();
+        BOOST_SCOPE_EXIT(spatialiteCache) {
+            spatialite_cleanup_ex(spatialiteCache);
+        } BOOST_SCOPE_EXIT_END
+        spatialite_init_ex(db.getHandle(), spatialiteCache, 0);
+        db.exec("SELECT InitSpatialMetaData(1);");
+
+        SQLite::Statement attachStmt{db, fmt::format("ATTACH DATABASE ? AS {};", AttachedSchemaName)};
+        attachStmt.bind(1, options.mapPath.string());
+        attachStmt.exec();
+
+        SQLite::Transaction transaction{db};
+        db.exec(R"SQL(
+            CREATE TABLE pyramid_levels (table_name TEXT NOT NULL, level_table TEXT NOT NULL, max_zoom INTEGER NOT NULL);
+        )SQL");
+        SQLite::Statement levelStmt{db, "INSERT INTO pyramid_levels VALUES (?, ?, ?);"};
+        for (const auto& table : options.tables)
+        {
+            const auto source = ReadSourceTable(db, boost::to_lower_copy(table));
+            // the coarser levels are simplified from the finer ones, they have fewer vertices to process
+            // and the tolerance doubles with every zoom level, so the error stays within twice the coarsest tolerance
+            auto from = fmt::format("{}.\"{}\"", AttachedSchemaName, source.name);
+            for (const auto maxZoom : maxZooms)
+            {
+                const auto levelTable = GetPyramidLevelTableName(source.name, maxZoom);
+                CreateLevelTable(db, source, levelTable);
+                const auto features = FillLevelTable(db, source, from, levelTable, 
+                    options.tolerancePixels * GetPixelSize(maxZoom));
+                CreateSpatialIndex(db, levelTable, source.geometryColumn);
+
+                levelStmt.bind(1, source.name);
+                levelStmt.bind(2, levelTable);
+                levelStmt.bind(3, static_cast<int>(maxZoom));
+                levelStmt.exec();
+                levelStmt.reset();
+                mapget::log().info("Built '{}' with {} features for the zoom levels up to {}", levelTable, features, maxZoom);
+                from = fmt::format("\"{}\"", levelTable);
+            }
+        }
+        transaction.commit();
+    }
+    std::filesystem::rename(tmpPath, options.pyramidPath);
+}
+
+} // namespace SpatialiteDatasource
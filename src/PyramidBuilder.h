@@ -0,0 +1,58 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Options of building a pyramid database: simplified copies of layer tables per zoom band
+ */
+struct PyramidBuildOptions
+{
+    std::filesystem::path mapPath;     /// Spatialite database with the layer tables
+    std::filesystem::path pyramidPath; /// Pyramid database, it's overwritten
+    std::vector<std::string> tables;   /// Layer tables to simplify, lines and polygons only
+    std::vector<uint16_t> maxZooms;    /// Last zoom level of every band
+    double tolerancePixels = 0.5;      /// Simplification tolerance in pixels of the last zoom level of a band
+};
+
+/**
+ * @brief Get the name of the simplified copy of the table for the zoom band
+ * 
+ * @param table Layer table
+ * @param maxZoom Last zoom level of the band
+ */
+[[nodiscard]] std::string GetPyramidLevelTableName(const std::string& table, uint16_t maxZoom);
+
+/**
+ * @brief Build the pyramid database. Every level table has all the columns of its layer table
+ *  with the same primary key values and a spatial index, the coarser levels are simplified from the finer ones.
+ *  The levels are listed in the 'pyramid_levels' table
+ */
+void BuildPyramid(const PyramidBuildOptions& options);
+
+} // namespace SpatialiteDatasource
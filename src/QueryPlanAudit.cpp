@@ -0,0 +1,139 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "QueryPlanAudit.h"
+
+#include "ConfigLoader.h"
+
+#include <mapget/log.h>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace SpatialiteDatasource {
+namespace {
+
+constexpr std::string_view LayerTableAlias = "layerTable";
+
+/**
+ * @brief Get the table that is read completely according to the plan row
+ */
+[[nodiscard]] std::optional<std::string> GetScannedTable(std::string_view detail)
+{
+    detail.remove_prefix(std::min(detail.find_first_not_of(' '), detail.size()));
+
+    const auto isScan = detail.starts_with("SCAN ");
+    const auto isAutomaticIndex = detail.find("AUTOMATIC") != std::string_view::npos;
+    if ((!isScan && !isAutomaticIndex) 
+        || detail.find("VIRTUAL TABLE") != std::string_view::npos 
+        || detail.find("CONSTANT ROW") != std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    detail.remove_prefix(std::min(detail.find(' ') + 1, detail.size()));
+    if (detail.starts_with("TABLE "))
+    {
+        // SQLite before 3.36 prints 'SCAN TABLE <name>'
+        detail.remove_prefix(std::string_view{"TABLE "}.size());
+    }
+    return std::string{detail.substr(0, detail.find(' '))};
+}
+
+[[nodiscard]] std::string FormatScans(const std::vector<TableScan>& scans)
+{
+    std::vector<std::string> formatted;
+    for (const auto& scan : scans)
+    {
+        formatted.push_back(fmt::format("'{}' (~{} rows)", scan.table, scan.estimatedRows));
+    }
+    return fmt::format("{}", fmt::join(formatted, ", "));
+}
+
+} // namespace
+
+[[nodiscard]] QueryPlanReport AuditQueryPlan(const Database& database, const TableInfo& tableInfo)
+{
+    QueryPlanReport report;
+    report.layer = tableInfo.name;
+    report.plan = database.ExplainQueryPlan(tableInfo.GetSqlQuery());
+    for (const auto& row : report.plan)
+    {
+        auto table = GetScannedTable(row);
+        if (!table.has_value())
+            continue;
+
+        if (*table == LayerTableAlias)
+            table = tableInfo.name;
+        const auto estimatedRows = database.EstimateRowsCount(*table);
+        report.fullScans.push_back({.table = std::move(*table), .estimatedRows = estimatedRows});
+        report.estimatedRowsPerQuery += estimatedRows;
+    }
+    return report;
+}
+
+void AuditQueryPlans(
+    const Database& database, 
+    const std::vector<const TableInfo*>& tablesInfo, 
+    const QueryPlanAuditOptions& options)
+{
+    if (options.onFullScan == FullScanPolicy::Ignore)
+        return;
+
+    std::vector<std::string> failedLayers;
+    for (const auto* tableInfo : tablesInfo)
+    {
+        QueryPlanReport report;
+        try
+        {
+            report = AuditQueryPlan(database, *tableInfo);
+        }
+        catch (const std::exception& e)
+        {
+            mapget::log().warn("Failed to audit the query plan of layer '{}': {}", tableInfo->name, e.what());
+            continue;
+        }
+
+        mapget::log().debug("Query plan of layer '{}':\n{}", report.layer, fmt::join(report.plan, "\n"));
+        if (report.fullScans.empty())
+        {
+            mapget::log().info("Query plan of layer '{}' is indexed", report.layer);
+            continue;
+        }
+
+        mapget::log().warn("Every tile query of layer '{}' scans {}, ~{} rows in total. "
+            "Create a spatial index or an index for the relation match condition",
+            report.layer, FormatScans(report.fullScans), report.estimatedRowsPerQuery);
+        failedLayers.push_back(report.layer);
+    }
+
+    if (!failedLayers.empty() && options.onFullScan == FullScanPolicy::Fail)
+    {
+        throw std::runtime_error{fmt::format("Query plan audit failed, layers with full table scans: {}", 
+            fmt::join(failedLayers, ", "))};
+    }
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,78 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "Database.h"
+#include "TableInfo.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+struct QueryPlanAuditOptions;
+
+/**
+ * @brief Table that is read completely by every tile query
+ */
+struct TableScan
+{
+    std::string table;
+    uint64_t estimatedRows = 0;
+};
+
+/**
+ * @brief Query plan of a layer with the full table scans found in it
+ */
+struct QueryPlanReport
+{
+    std::string layer;
+    std::vector<std::string> plan;
+    std::vector<TableScan> fullScans;
+    uint64_t estimatedRowsPerQuery = 0; /// Rows read by the full scans of a single tile query
+};
+
+/**
+ * @brief Explain the tile query of the layer and find the full table scans in it: 
+ *  'SCAN' of a table (not of a spatial index virtual table) or an automatic index,
+ *  which SQLite builds by reading the whole table on every query
+ * 
+ * @param database Database to explain the query on
+ * @param tableInfo Layer to audit
+ */
+[[nodiscard]] QueryPlanReport AuditQueryPlan(const Database& database, const TableInfo& tableInfo);
+
+/**
+ * @brief Audit the query plans of the layers and report them to the log
+ * 
+ * @param database Database to explain the queries on
+ * @param tablesInfo Layers to audit
+ * @param options Audit options
+ * @throw std::runtime_error if a layer does a full table scan and the audit is configured to fail
+ */
+void AuditQueryPlans(
+    const Database& database, 
+    const std::vector<const TableInfo*>& tablesInfo, 
+    const QueryPlanAuditOptions& options);
+
+} // namespace SpatialiteDatasource
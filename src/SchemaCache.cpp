@@ -0,0 +1,210 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "SchemaCache.h"
+
+#include <mapget/log.h>
+#include <fmt/format.h>
+
+#include <fstream>
+#include <random>
+#include <ranges>
+#include <system_error>
+
+namespace SpatialiteDatasource {
+namespace {
+
+// Must be increased whenever the snapshot format or the meaning of TableInfo fields change
+constexpr int SnapshotVersion = 1;
+
+[[nodiscard]] std::string GetFileIdentity(const std::filesystem::path& path)
+{
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return "-";
+    }
+    const auto modified = std::filesystem::last_write_time(path, error);
+    return fmt::format("{}:{}", size, modified.time_since_epoch().count());
+}
+
+[[nodiscard]] nlohmann::json TableInfoToJson(const TableInfo& tableInfo)
+{
+    auto attributes = nlohmann::json::object();
+    for (const auto& [name, attribute] : tableInfo.attributes)
+    {
+        auto& attributeJson = attributes[name];
+        attributeJson["type"] = static_cast<int>(attribute.type);
+        if (attribute.relation.has_value())
+        {
+            attributeJson["relation"] = {
+                {"columns", attribute.relation->columns},
+                {"delimiter", attribute.relation->delimiter},
+                {"matchCondition", attribute.relation->matchCondition}
+            };
+        }
+    }
+    return {
+        {"name", tableInfo.name},
+        {"primaryKey", tableInfo.primaryKey},
+        {"geometryColumn", tableInfo.geometryColumn},
+        {"geometryType", static_cast<int>(tableInfo.geometryType)},
+        {"dimension", static_cast<int>(tableInfo.dimension)},
+        {"spatialIndex", static_cast<int>(tableInfo.spatialIndex)},
+        {"scaling", {tableInfo.scaling.x, tableInfo.scaling.y, tableInfo.scaling.z}},
+        {"attributes", std::move(attributes)}
+    };
+}
+
+[[nodiscard]] TableInfo TableInfoFromJson(const nlohmann::json& json)
+{
+    TableInfo tableInfo;
+    tableInfo.name = json.at("name").get<std::string>();
+    tableInfo.primaryKey = json.at("primaryKey").get<std::string>();
+    tableInfo.geometryColumn = json.at("geometryColumn").get<std::string>();
+    tableInfo.geometryType = static_cast<GeometryType>(json.at("geometryType").get<int>());
+    tableInfo.dimension = static_cast<Dimension>(json.at("dimension").get<int>());
+    tableInfo.spatialIndex = static_cast<SpatialIndex>(json.at("spatialIndex").get<int>());
+    const auto& scaling = json.at("scaling");
+    tableInfo.scaling = {scaling.at(0).get<double>(), scaling.at(1).get<double>(), scaling.at(2).get<double>()};
+    for (const auto& [name, attributeJson] : json.at("attributes").items())
+    {
+        auto& attribute = tableInfo.attributes[name];
+        attribute.type = static_cast<ColumnType>(attributeJson.at("type").get<int>());
+        if (const auto relationIt = attributeJson.find("relation"); relationIt != attributeJson.end())
+        {
+            auto& relation = attribute.relation.emplace();
+            relation.columns = relationIt->at("columns").get<std::vector<std::string>>();
+            relation.delimiter = relationIt->at("delimiter").get<std::string>();
+            relation.matchCondition = relationIt->at("matchCondition").get<std::string>();
+        }
+    }
+    return tableInfo;
+}
+
+} // anonymous namespace
+
+[[nodiscard]] std::string GetDatabaseIdentity(const std::filesystem::path& dbPath)
+{
+    std::error_code error;
+    auto path = std::filesystem::weakly_canonical(dbPath, error);
+    if (error)
+    {
+        path = dbPath;
+    }
+    // Changes may stay in the write-ahead log without touching the database file
+    auto walPath = path;
+    walPath += "-wal";
+    return fmt::format("{}|{}|{}", path.string(), GetFileIdentity(path), GetFileIdentity(walPath));
+}
+
+[[nodiscard]] uint64_t GetStableHash(std::string_view value) noexcept
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto c : value)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+[[nodiscard]] std::optional<SchemaSnapshot> LoadSchemaSnapshot(
+    const std::filesystem::path& cachePath, const std::string& fingerprint)
+{
+    std::ifstream file{cachePath};
+    if (!file)
+    {
+        mapget::log().info("No schema cache found at '{}'", cachePath.string());
+        return std::nullopt;
+    }
+
+    try
+    {
+        const auto json = nlohmann::json::parse(file);
+        if (json.at("version").get<int>() != SnapshotVersion || json.at("fingerprint").get<std::string>() != fingerprint)
+        {
+            mapget::log().info("Schema cache '{}' is outdated", cachePath.string());
+            return std::nullopt;
+        }
+
+        SchemaSnapshot snapshot;
+        snapshot.datasourceConfig = json.at("datasourceConfig");
+        for (const auto& tableJson : json.at("tables"))
+        {
+            auto tableInfo = TableInfoFromJson(tableJson);
+            auto name = tableInfo.name;
+            snapshot.tablesInfo.emplace(std::move(name), std::move(tableInfo));
+        }
+        return snapshot;
+    }
+    catch (const std::exception& e)
+    {
+        mapget::log().warn("Failed to load schema cache '{}': {}", cachePath.string(), e.what());
+        return std::nullopt;
+    }
+}
+
+void StoreSchemaSnapshot(
+    const std::filesystem::path& cachePath, const std::string& fingerprint, const SchemaSnapshot& snapshot)
+{
+    auto tables = nlohmann::json::array();
+    for (const auto& tableInfo : std::views::values(snapshot.tablesInfo))
+    {
+        tables.push_back(TableInfoToJson(tableInfo));
+    }
+    const nlohmann::json json{
+        {"version", SnapshotVersion},
+        {"fingerprint", fingerprint},
+        {"datasourceConfig", snapshot.datasourceConfig},
+        {"tables", std::move(tables)}
+    };
+
+    // Written to a temporary file of this writer first, so that concurrently starting instances 
+    // neither write to the same file nor read a partial cache, the rename replaces the cache atomically
+    auto tmpPath = cachePath;
+    tmpPath += fmt::format(".{:08x}.tmp", std::random_device{}());
+    {
+        std::ofstream file{tmpPath, std::ios::trunc};
+        file << json.dump();
+        if (!file)
+        {
+            mapget::log().warn("Failed to write schema cache '{}'", tmpPath.string());
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(tmpPath, error);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath, cachePath, error);
+    if (error)
+    {
+        mapget::log().warn("Failed to write schema cache '{}': {}", cachePath.string(), error.message());
+        std::filesystem::remove(tmpPath, error);
+        return;
+    }
+    mapget::log().info("Schema cache is stored to '{}'", cachePath.string());
+}
+
+} // namespace SpatialiteDatasource
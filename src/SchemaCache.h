@@ -0,0 +1,77 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "TableInfo.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Result of the schema discovery: mapget datasource config and tables info
+ */
+struct SchemaSnapshot
+{
+    nlohmann::json datasourceConfig;
+    TablesInfo tablesInfo;
+};
+
+/**
+ * @brief Get a string that changes whenever the database file is modified
+ * 
+ * @param dbPath Path to a spatialite database
+ */
+[[nodiscard]] std::string GetDatabaseIdentity(const std::filesystem::path& dbPath);
+
+/**
+ * @brief Get a stable (across runs and builds) 64-bit hash of the string
+ */
+[[nodiscard]] uint64_t GetStableHash(std::string_view value) noexcept;
+
+/**
+ * @brief Load the schema snapshot from the cache file
+ * 
+ * @param cachePath Path to the cache file
+ * @param fingerprint Identity of the database and the config the snapshot must be created for
+ * @return Snapshot or nullopt if there is no cache, it's corrupted or created for another fingerprint
+ */
+[[nodiscard]] std::optional<SchemaSnapshot> LoadSchemaSnapshot(
+    const std::filesystem::path& cachePath, const std::string& fingerprint);
+
+/**
+ * @brief Store the schema snapshot to the cache file, failures are only logged
+ * 
+ * @param cachePath Path to the cache file
+ * @param fingerprint Identity of the database and the config the snapshot was created for
+ * @param snapshot Schema snapshot
+ */
+void StoreSchemaSnapshot(
+    const std::filesystem::path& cachePath, const std::string& fingerprint, const SchemaSnapshot& snapshot);
+
+} // namespace SpatialiteDatasource
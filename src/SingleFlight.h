@@ -0,0 +1,98 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Coalesces concurrent calls with the same key:
+ *  the first caller computes the value, others wait for it and receive the same value
+ *
+ * @tparam Key Key of the call
+ * @tparam Value Result of the call, copied to every waiting caller
+ */
+template <class Key, class Value, class Hash = std::hash<Key>>
+class SingleFlight
+{
+public:
+    struct Result
+    {
+        Value value;
+        bool isShared; /// true if the value was computed by another caller
+    };
+
+    /**
+     * @brief Call the function, or wait for the in-flight call with the same key
+     *
+     * @param key Key of the call
+     * @param function Function that computes the value
+     * @return Computed value and whether it was shared with another caller
+     */
+    template <class Function>
+    Result Do(const Key& key, Function&& function)
+    {
+        std::unique_lock lock{m_mutex};
+        if (const auto it = m_inFlight.find(key); it != m_inFlight.end())
+        {
+            auto future = it->second;
+            lock.unlock();
+            return {future.get(), true};
+        }
+
+        std::promise<Value> promise;
+        m_inFlight.emplace(key, promise.get_future().share());
+        lock.unlock();
+
+        try
+        {
+            Value value = std::invoke(std::forward<Function>(function));
+            Forget(key);
+            promise.set_value(value);
+            return {std::move(value), false};
+        }
+        catch (...)
+        {
+            Forget(key);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+private:
+    void Forget(const Key& key)
+    {
+        std::lock_guard lock{m_mutex};
+        m_inFlight.erase(key);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<Key, std::shared_future<Value>, Hash> m_inFlight;
+};
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,100 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "SlowQueryLog.h"
+
+#include "ConfigLoader.h"
+
+#include <mapget/log.h>
+#include <nlohmann/json.hpp>
+
+#include <stdexcept>
+
+namespace SpatialiteDatasource {
+namespace {
+
+[[nodiscard]] double ToMilliseconds(std::chrono::nanoseconds duration) noexcept
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+[[nodiscard]] nlohmann::json ToJson(const SlowQuery& query)
+{
+    return {
+        {"unixTimeMs", std::chrono::duration_cast<std::chrono::milliseconds>(query.time.time_since_epoch()).count()},
+        {"table", query.table},
+        {"mbr", {query.mbr.xmin, query.mbr.ymin, query.mbr.xmax, query.mbr.ymax}},
+        {"sql", query.sql},
+        {"plan", query.plan},
+        {"rows", query.rows},
+        {"totalMs", ToMilliseconds(query.totalTime)},
+        {"acquireMs", ToMilliseconds(query.acquireTime)},
+        {"queryMs", ToMilliseconds(query.queryTime)},
+        {"decodeMs", ToMilliseconds(query.decodeTime)}
+    };
+}
+
+} // namespace
+
+SlowQueryLog::SlowQueryLog(const SlowQueryLogOptions& options)
+    : m_threshold{options.threshold}
+    , m_capacity{options.capacity}
+{
+    if (m_threshold.count() > 0 && m_capacity == 0)
+    {
+        throw std::runtime_error{"Slow query log capacity must be greater than 0"};
+    }
+    m_queries.reserve(m_capacity);
+}
+
+[[nodiscard]] bool SlowQueryLog::IsSlow(std::chrono::nanoseconds duration) const noexcept
+{
+    return m_threshold.count() > 0 && duration >= m_threshold;
+}
+
+void SlowQueryLog::Record(SlowQuery query)
+{
+    mapget::log().warn("Slow query of table '{}': {:.1f}ms (acquire {:.1f}ms, query {:.1f}ms, decode {:.1f}ms), {} rows",
+        query.table, ToMilliseconds(query.totalTime), ToMilliseconds(query.acquireTime), 
+        ToMilliseconds(query.queryTime), ToMilliseconds(query.decodeTime), query.rows);
+
+    std::lock_guard lock{m_mutex};
+    if (m_queries.size() < m_capacity)
+    {
+        m_queries.push_back(std::move(query));
+        return;
+    }
+    m_queries[m_next] = std::move(query);
+    m_next = (m_next + 1) % m_capacity;
+}
+
+[[nodiscard]] std::string SlowQueryLog::Dump() const
+{
+    auto result = nlohmann::json::array();
+    std::lock_guard lock{m_mutex};
+    for (size_t i = 0; i < m_queries.size(); ++i)
+    {
+        result.push_back(ToJson(m_queries[(m_next + i) % m_queries.size()]));
+    }
+    return result.dump(2);
+}
+
+} // namespace SpatialiteDatasource
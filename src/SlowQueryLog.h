@@ -0,0 +1,85 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "Mbr.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+struct SlowQueryLogOptions;
+
+/**
+ * @brief Tile query that exceeded the slow query threshold
+ */
+struct SlowQuery
+{
+    std::chrono::system_clock::time_point time;
+    std::string table;
+    Mbr mbr;
+    std::string sql;               /// SQL with the bound parameters
+    std::vector<std::string> plan; /// 'EXPLAIN QUERY PLAN' rows, indented by their depth
+    uint64_t rows = 0;
+    std::chrono::nanoseconds totalTime{0};
+    std::chrono::nanoseconds acquireTime{0}; /// Waiting for a pooled connection
+    std::chrono::nanoseconds queryTime{0};   /// Stepping the statement without the decoding in the same thread
+    std::chrono::nanoseconds decodeTime{0};  /// Summed over all decoding threads
+};
+
+/**
+ * @brief Keeps the latest slow tile queries in a bounded ring buffer
+ */
+class SlowQueryLog
+{
+public:
+    explicit SlowQueryLog(const SlowQueryLogOptions& options);
+
+    /**
+     * @brief Whether a query of the given duration must be recorded
+     */
+    [[nodiscard]] bool IsSlow(std::chrono::nanoseconds duration) const noexcept;
+
+    /**
+     * @brief Record the query, the oldest one is dropped if the buffer is full
+     */
+    void Record(SlowQuery query);
+
+    /**
+     * @brief Get the recorded queries as a JSON array, the oldest first
+     */
+    [[nodiscard]] std::string Dump() const;
+
+private:
+    const std::chrono::nanoseconds m_threshold;
+    const size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+    std::vector<SlowQuery> m_queries;
+    size_t m_next = 0; /// Position of the next query once the buffer is full
+};
+
+} // namespace SpatialiteDatasource
@@ -102,6 +102,16 @@ TableInfo::TableInfo(const std::string& name, const Database& db) : name{name}
     spatialIndex = db.GetSpatialIndexType(name);
 }
 
+TableInfo::TableInfo(const std::string& name, const Database& db, const TableMetadata& metadata) : name{name}
+{
+    primaryKey = metadata.primaryKey.has_value() ? *metadata.primaryKey : db.GetPrimaryKeyColumnName(name);
+    CheckSrid(name, metadata.srid);
+    geometryColumn = metadata.geometryColumn;
+    geometryType = GetGeometryType(metadata.geometryType);
+    dimension = GetDimension(metadata.geometryType);
+    spatialIndex = db.GetSpatialIndexType(name, metadata.spatialIndexEnabled);
+}
+
 const std::string& TableInfo::GetSqlQuery() const
 {
     if (m_sqlQuery.empty())
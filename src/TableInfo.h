@@ -71,12 +71,17 @@ struct ScalingInfo
 };
 
 struct Database;
+struct TableMetadata;
 
 struct TableInfo
 {
     TableInfo() = default;
     TableInfo(const std::string& name, const Database& db);
+    TableInfo(const std::string& name, const Database& db, const TableMetadata& metadata);
 
+    /**
+     * @brief Get the SQL query of the table geometries, it's built on the first call which is not thread-safe
+     */
     const std::string& GetSqlQuery() const;
     [[nodiscard]] bool operator==(const TableInfo&) const = default;
 
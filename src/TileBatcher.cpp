@@ -0,0 +1,163 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "TileBatcher.h"
+#include "Tracing.h"
+
+#include <mapget/log.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace SpatialiteDatasource {
+namespace {
+
+[[nodiscard]] std::shared_ptr<const TileFeatures> SelectTileFeatures(
+    const std::shared_ptr<const BufferedFeatures>& buffer,
+    const std::vector<std::optional<Mbr>>& featuresMbrs,
+    const Mbr& tileMbr)
+{
+    auto result = std::make_shared<TileFeatures>();
+    result->buffer = buffer;
+    for (size_t i = 0; i < buffer->size(); ++i)
+    {
+        // features without points can't be matched with a tile, so they go to every tile
+        if (!featuresMbrs[i].has_value() || Intersects(*featuresMbrs[i], tileMbr))
+        {
+            result->features.push_back(&(*buffer)[i]);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+[[nodiscard]] Mbr GetTileMbr(const mapget::TileId& tileId)
+{
+    return {
+        .xmin = tileId.sw().x,
+        .ymin = tileId.sw().y,
+        .xmax = tileId.ne().x,
+        .ymax = tileId.ne().y
+    };
+}
+
+TileBatcher::TileBatcher(const TileBatchingOptions& options, ReadFunction read)
+    : m_options{options}
+    , m_read{std::move(read)}
+{}
+
+[[nodiscard]] std::shared_ptr<const TileFeatures> TileBatcher::Read(const TableInfo& tableInfo, const mapget::TileId& tileId)
+{
+    const auto tileMbr = GetTileMbr(tileId);
+    if (m_options.window.count() == 0)
+    {
+        auto buffer = std::make_shared<const BufferedFeatures>(m_read(tableInfo, tileMbr, tileId.z()));
+        auto result = std::make_shared<TileFeatures>();
+        result->buffer = buffer;
+        result->features.reserve(buffer->size());
+        for (const auto& feature : *buffer)
+        {
+            result->features.push_back(&feature);
+        }
+        return result;
+    }
+
+    std::unique_lock lock{m_mutex};
+    auto& openBatches = m_openBatches[tableInfo.name];
+    for (const auto& batch : openBatches)
+    {
+        if (CanJoin(*batch, tileId, tileMbr))
+        {
+            batch->mbr = Union(batch->mbr, tileMbr);
+            auto future = batch->followers.emplace_back(tileMbr).promise.get_future();
+            lock.unlock();
+            ScopedSpan span{"batch wait"};
+            return future.get();
+        }
+    }
+
+    // no suitable batch, so this request opens a new one and reads it when the window is over
+    auto batch = std::make_shared<Batch>(tileId.z(), tileMbr, tileMbr);
+    openBatches.push_back(batch);
+    lock.unlock();
+
+    {
+        ScopedSpan span{"batch window"};
+        std::this_thread::sleep_for(m_options.window);
+    }
+
+    lock.lock();
+    std::erase(m_openBatches[tableInfo.name], batch);
+    lock.unlock();
+
+    return ReadBatch(tableInfo, *batch);
+}
+
+[[nodiscard]] bool TileBatcher::CanJoin(const Batch& batch, const mapget::TileId& tileId, const Mbr& tileMbr) const
+{
+    if (batch.zoom != tileId.z() || batch.followers.size() + 1 >= m_options.maxTiles)
+        return false;
+
+    // tiles of the same zoom level have the same size,
+    // so the batch MBR must not be larger than maxTiles tiles
+    const auto mbr = Union(batch.mbr, tileMbr);
+    const auto width = std::lround((mbr.xmax - mbr.xmin) / (batch.tileMbr.xmax - batch.tileMbr.xmin));
+    const auto height = std::lround((mbr.ymax - mbr.ymin) / (batch.tileMbr.ymax - batch.tileMbr.ymin));
+    return static_cast<size_t>(width * height) <= m_options.maxTiles;
+}
+
+[[nodiscard]] std::shared_ptr<const TileFeatures> TileBatcher::ReadBatch(const TableInfo& tableInfo, Batch& batch)
+{
+    try
+    {
+        const auto buffer = std::make_shared<const BufferedFeatures>(m_read(tableInfo, batch.mbr, batch.zoom));
+
+        std::vector<std::optional<Mbr>> featuresMbrs;
+        featuresMbrs.reserve(buffer->size());
+        for (const auto& feature : *buffer)
+        {
+            featuresMbrs.push_back(feature.GetMbr());
+        }
+
+        for (auto& follower : batch.followers)
+        {
+            follower.promise.set_value(SelectTileFeatures(buffer, featuresMbrs, follower.mbr));
+        }
+        if (!batch.followers.empty())
+        {
+            mapget::log().debug("Read {} tiles of table '{}' with a single query ({} features)",
+                batch.followers.size() + 1, tableInfo.name, buffer->size());
+        }
+        return SelectTileFeatures(buffer, featuresMbrs, batch.tileMbr);
+    }
+    catch (...)
+    {
+        for (auto& follower : batch.followers)
+        {
+            follower.promise.set_exception(std::current_exception());
+        }
+        throw;
+    }
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,100 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "BufferedFeature.h"
+#include "ConfigLoader.h"
+#include "Mbr.h"
+#include "TableInfo.h"
+
+#include <mapget/model/featurelayer.h>
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+/**
+ * @brief Get the MBR of the tile
+ */
+[[nodiscard]] Mbr GetTileMbr(const mapget::TileId& tileId);
+
+/**
+ * @brief Collects requests for the tiles of the same table that arrive within a short time window,
+ *  reads features for all of them with a single query over the batch MBR 
+ *  and distributes the features between the tiles they intersect
+ */
+class TileBatcher
+{
+public:
+    using ReadFunction = std::function<BufferedFeatures(const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom)>;
+
+    /**
+     * @brief Construct a new Tile Batcher object
+     * 
+     * @param options Batching options
+     * @param read Function that reads and decodes features of the table within MBR for the tiles of the zoom level
+     */
+    TileBatcher(const TileBatchingOptions& options, ReadFunction read);
+
+    /**
+     * @brief Read features of the table within the tile, possibly together with other tiles
+     * 
+     * @param tableInfo Table which contains geometries
+     * @param tileId Requested tile
+     */
+    [[nodiscard]] std::shared_ptr<const TileFeatures> Read(const TableInfo& tableInfo, const mapget::TileId& tileId);
+
+private:
+    struct BatchedTile
+    {
+        Mbr mbr;
+        std::promise<std::shared_ptr<const TileFeatures>> promise;
+    };
+
+    struct Batch
+    {
+        uint16_t zoom;
+        Mbr tileMbr;   /// MBR of the first tile in the batch
+        Mbr mbr;       /// MBR of all tiles in the batch
+        std::vector<BatchedTile> followers;
+    };
+
+    [[nodiscard]] bool CanJoin(const Batch& batch, const mapget::TileId& tileId, const Mbr& tileMbr) const;
+    [[nodiscard]] std::shared_ptr<const TileFeatures> ReadBatch(const TableInfo& tableInfo, Batch& batch);
+
+private:
+    const TileBatchingOptions m_options;
+    const ReadFunction m_read;
+
+    std::mutex m_mutex;
+    std::unordered_map<
+        std::string, // table
+        std::vector<std::shared_ptr<Batch>>> m_openBatches;
+};
+
+} // namespace SpatialiteDatasource
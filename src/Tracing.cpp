@@ -0,0 +1,184 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Tracing.h"
+
+#include "ConfigLoader.h"
+
+#include <mapget/log.h>
+
+#include <random>
+#include <stdexcept>
+
+namespace SpatialiteDatasource {
+namespace {
+
+thread_local Trace* CurrentTrace = nullptr;
+
+[[nodiscard]] uint32_t GetThreadNumber() noexcept
+{
+    static std::atomic<uint32_t> nextThreadNumber{1};
+    thread_local const uint32_t threadNumber = nextThreadNumber++;
+    return threadNumber;
+}
+
+} // namespace
+
+Trace::Trace(Tracer& tracer, uint64_t id) noexcept
+    : m_tracer{tracer}
+    , m_id{id}
+{}
+
+Trace::~Trace()
+{
+    try
+    {
+        m_tracer.Write(m_id, m_spans);
+    }
+    catch (const std::exception& e)
+    {
+        mapget::log().error("Failed to write trace {}: {}", m_id, e.what());
+    }
+}
+
+void Trace::AddSpan(std::string_view name, Clock::time_point start, Clock::time_point end, nlohmann::json args)
+{
+    std::lock_guard lock{m_mutex};
+    m_spans.push_back({name, start, end, GetThreadNumber(), std::move(args)});
+}
+
+[[nodiscard]] Trace* Trace::Current() noexcept
+{
+    return CurrentTrace;
+}
+
+TraceScope::TraceScope(Trace* trace) noexcept
+    : m_previous{std::exchange(CurrentTrace, trace)}
+{}
+
+TraceScope::~TraceScope()
+{
+    CurrentTrace = m_previous;
+}
+
+ScopedSpan::ScopedSpan(std::string_view name) noexcept
+    : m_trace{Trace::Current()}
+    , m_name{name}
+{
+    if (m_trace != nullptr)
+        m_start = Trace::Clock::now();
+}
+
+ScopedSpan::~ScopedSpan()
+{
+    if (m_trace == nullptr)
+        return;
+    try
+    {
+        m_trace->AddSpan(m_name, m_start, Trace::Clock::now(), std::move(m_args));
+    }
+    catch (...)
+    {
+        // tracing must never break a request
+    }
+}
+
+Tracer::Tracer(const TracingOptions& options)
+    : m_isChromeFormat{options.format == TraceFormat::Chrome}
+    , m_sampleRate{options.path.empty() ? 0. : options.sampleRate}
+    , m_epoch{Trace::Clock::now()}
+{
+    if (options.path.empty())
+        return;
+
+    m_file.open(options.path, std::ios::trunc);
+    if (!m_file)
+    {
+        throw std::runtime_error{fmt::format("Failed to open trace file '{}'", options.path.string())};
+    }
+    if (m_isChromeFormat)
+    {
+        // the closing bracket is optional in the trace event format, so the file is valid at any time
+        m_file << "[\n";
+    }
+    mapget::log().info("Tracing {}% of tile requests to '{}'", m_sampleRate * 100, options.path.string());
+}
+
+[[nodiscard]] std::unique_ptr<Trace> Tracer::StartTrace()
+{
+    if (m_sampleRate <= 0.)
+        return nullptr;
+
+    thread_local std::minstd_rand random{std::random_device{}()};
+    if (m_sampleRate < 1. && std::uniform_real_distribution<double>{0., 1.}(random) >= m_sampleRate)
+        return nullptr;
+
+    return std::make_unique<Trace>(*this, m_nextTraceId++);
+}
+
+void Tracer::Write(uint64_t traceId, const std::vector<Trace::Span>& spans)
+{
+    const auto toUs = [this](Trace::Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time - m_epoch).count();
+    };
+
+    std::string out;
+    for (const auto& span : spans)
+    {
+        nlohmann::json event;
+        if (m_isChromeFormat)
+        {
+            event = {
+                {"name", span.name},
+                {"cat", "tile"},
+                {"ph", "X"},
+                {"ts", toUs(span.start)},
+                {"dur", toUs(span.end) - toUs(span.start)},
+                {"pid", 1},
+                {"tid", span.thread},
+                {"args", span.args.is_null() ? nlohmann::json::object() : span.args}
+            };
+            event["args"]["trace"] = traceId;
+            out += event.dump();
+            out += ",\n";
+        }
+        else
+        {
+            event = {
+                {"trace", traceId},
+                {"name", span.name},
+                {"startUs", toUs(span.start)},
+                {"durationUs", toUs(span.end) - toUs(span.start)},
+                {"thread", span.thread}
+            };
+            if (!span.args.is_null())
+                event["args"] = span.args;
+            out += event.dump();
+            out += '\n';
+        }
+    }
+
+    std::lock_guard lock{m_mutex};
+    m_file << out;
+    m_file.flush();
+}
+
+} // namespace SpatialiteDatasource
@@ -0,0 +1,165 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace SpatialiteDatasource {
+
+struct TracingOptions;
+class Tracer;
+
+/**
+ * @brief Spans of a single sampled tile request. The spans may be added from any thread,
+ *  they are written by the tracer when the trace is destroyed
+ */
+class Trace
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Span
+    {
+        std::string_view name; /// Must be a string literal
+        Clock::time_point start;
+        Clock::time_point end;
+        uint32_t thread;
+        nlohmann::json args;
+    };
+
+    Trace(Tracer& tracer, uint64_t id) noexcept;
+    ~Trace();
+
+    Trace(const Trace&) = delete;
+    Trace& operator=(const Trace&) = delete;
+
+    /**
+     * @brief Add a finished span, thread-safe
+     */
+    void AddSpan(std::string_view name, Clock::time_point start, Clock::time_point end, nlohmann::json args = {});
+
+    /**
+     * @brief Get the trace of the current thread, nullptr if the request is not sampled
+     */
+    [[nodiscard]] static Trace* Current() noexcept;
+
+private:
+    friend class TraceScope;
+
+    Tracer& m_tracer;
+    const uint64_t m_id;
+    std::mutex m_mutex;
+    std::vector<Span> m_spans;
+};
+
+/**
+ * @brief Makes the trace current for the thread within the scope
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(Trace* trace) noexcept;
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    Trace* m_previous;
+};
+
+/**
+ * @brief Adds a span for the scope to the current trace of the thread, does nothing if there is none
+ */
+class ScopedSpan
+{
+public:
+    explicit ScopedSpan(std::string_view name) noexcept;
+    ~ScopedSpan();
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    /**
+     * @brief Whether the span is recorded, so that args are worth collecting
+     */
+    [[nodiscard]] bool IsActive() const noexcept { return m_trace != nullptr; }
+
+    /**
+     * @brief Set an argument of the span, ignored if the span is not recorded
+     */
+    template <class T>
+    void SetArg(const char* name, T&& value)
+    {
+        if (m_trace != nullptr)
+            m_args[name] = std::forward<T>(value);
+    }
+
+private:
+    Trace* m_trace;
+    std::string_view m_name;
+    Trace::Clock::time_point m_start;
+    nlohmann::json m_args;
+};
+
+/**
+ * @brief Samples tile requests and writes spans of the sampled ones to a file,
+ *  either as JSON lines or in Chrome trace event format (chrome://tracing, Perfetto)
+ */
+class Tracer
+{
+public:
+    explicit Tracer(const TracingOptions& options);
+
+    /**
+     * @brief Start a trace of a request if it's sampled
+     * 
+     * @return Trace or nullptr if tracing is disabled or the request is not sampled
+     */
+    [[nodiscard]] std::unique_ptr<Trace> StartTrace();
+
+private:
+    friend class Trace;
+
+    void Write(uint64_t traceId, const std::vector<Trace::Span>& spans);
+
+private:
+    const bool m_isChromeFormat;
+    const double m_sampleRate;
+    const Trace::Clock::time_point m_epoch;
+    std::atomic<uint64_t> m_nextTraceId{1};
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+};
+
+} // namespace SpatialiteDatasource
@@ -20,6 +20,7 @@
 
 #include "Datasource.h"
 #include "ConfigLoader.h"
+#include "PyramidBuilder.h"
 
 #include <mapget/log.h>
 
@@ -42,6 +43,7 @@ int main(int argc, char** argv)
     std::filesystem::path mapPath{}, configPath{};
     uint16_t port{0};
     bool isVerbose{false}, isNoAttributes{false}, isAttributes{false};
+    SpatialiteDatasource::PyramidBuildOptions pyramidOptions;
 
     po::options_description description{"Allowed options"};
     description.add_options()
@@ -51,7 +53,14 @@ int main(int argc, char** argv)
         ("config,c", po::value(&configPath), "path to a datasource config in json format (will retrieve the info from the db if not provided)")
         ("attributes", po::bool_switch(&isAttributes), "enable features attributes (enabled by default)")
         ("no-attributes", po::bool_switch(&isNoAttributes), "disable features attributes ")
-        ("verbose,v", po::bool_switch(&isVerbose), "enable debug logs");
+        ("verbose,v", po::bool_switch(&isVerbose), "enable debug logs")
+        ("build-pyramid", po::value(&pyramidOptions.pyramidPath), 
+            "build a pyramid database with simplified copies of the tables at this path from the '--map' and exit")
+        ("pyramid-table", po::value(&pyramidOptions.tables)->composing(), "table to simplify for '--build-pyramid', repeatable")
+        ("pyramid-zoom", po::value(&pyramidOptions.maxZooms)->composing(), 
+            "last zoom level of a band of '--build-pyramid', repeatable")
+        ("pyramid-tolerance", po::value(&pyramidOptions.tolerancePixels)->default_value(0.5), 
+            "simplification tolerance of '--build-pyramid' in pixels of the last zoom level of a band");
 
     po::variables_map vm;
     try 
@@ -69,6 +78,11 @@ int main(int argc, char** argv)
             throw std::runtime_error("Conflicting options were provided");
         }
 
+        if (vm.contains("build-pyramid") && !vm.contains("map"))
+        {
+            throw std::runtime_error("'--build-pyramid' requires '--map'");
+        }
+
         po::notify(vm);
     }
     catch (std::exception& e)
@@ -86,6 +100,21 @@ int main(int argc, char** argv)
         spatialite_shutdown();
     } BOOST_SCOPE_EXIT_END
 
+    if (vm.contains("build-pyramid"))
+    {
+        pyramidOptions.mapPath = mapPath;
+        try
+        {
+            SpatialiteDatasource::BuildPyramid(pyramidOptions);
+        }
+        catch (const std::exception& e)
+        {
+            mapget::log().error("Can't build the pyramid: {}", e.what());
+            return -1;
+        }
+        return 0;
+    }
+
     SpatialiteDatasource::OverrideOptions options;
     if (vm.contains("port"))
     {
@@ -0,0 +1,117 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cerrno>
+#include <cstdlib>
+
+// glibc exports its allocator under these names, so the interposed functions can forward to it
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+// constant-initialized, since allocations happen before and after the static initialization
+constinit std::atomic<bool> isCounting{false};
+constinit std::atomic<uint64_t> allocations{0};
+constinit std::atomic<uint64_t> bytes{0};
+
+void Count(size_t size) noexcept
+{
+    if (isCounting.load(std::memory_order_relaxed))
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size)
+{
+    Count(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    Count(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    Count(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    Count(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    Count(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    Count(size);
+    *ptr = __libc_memalign(alignment, size);
+    return *ptr == nullptr ? ENOMEM : 0;
+}
+
+} // extern "C"
+
+AllocationCounter::AllocationCounter() noexcept
+{
+    allocations.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    isCounting.store(true, std::memory_order_release);
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    isCounting.store(false, std::memory_order_release);
+}
+
+[[nodiscard]] AllocationCount AllocationCounter::Get() const noexcept
+{
+    return {allocations.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,205 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * Allocation regression test of the tile read path: geometries are queried, decoded into
+ * buffered features and added to a feature, like 'CreateGeometries' does, while all heap
+ * allocations are counted. The test fails if allocations or bytes per feature or per vertex
+ * exceed the budgets below. If a change legitimately needs more, raise the budget in the same change;
+ * if it needs less, lower it, so the gain is kept.
+ */
+
+#include "AllocationCounter.h"
+#include "DatabaseTestFixture.h"
+
+#include <BufferedFeature.h>
+#include <DecodePipeline.h>
+#include <IFeature.h>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <string>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+constexpr int FeaturesCount = 500;
+
+/**
+ * @brief Feature that only counts the vertices, so the test measures the datasource alone
+ */
+class CountingFeature : public IFeature
+{
+    class CountingGeometry : public IGeometry
+    {
+    public:
+        explicit CountingGeometry(uint64_t& vertices) noexcept : m_vertices{vertices} {}
+        void AddPoint(const mapget::Point&) override { ++m_vertices; }
+
+    private:
+        uint64_t& m_vertices;
+    };
+
+public:
+    IGeometry& AddGeometry(GeometryType, size_t) override { return m_geometry; }
+    void AddAttribute(std::string_view, int64_t) override {}
+    void AddAttribute(std::string_view, double) override {}
+    void AddAttribute(std::string_view, std::string_view) override {}
+
+    uint64_t vertices = 0;
+
+private:
+    CountingGeometry m_geometry{vertices};
+};
+
+/**
+ * @brief Upper bounds of the allocations, measured after a warm-up request
+ */
+struct AllocationBudget
+{
+    double allocationsPerFeature;
+    double bytesPerFeature;
+    double allocationsPerVertex;
+    double bytesPerVertex;
+};
+
+struct AllocationScenario
+{
+    std::string name;
+    std::string spatialiteType;
+    GeometryType geometryType;
+    int verticesPerFeature;
+    bool hasAttributes;
+    AllocationBudget budget;
+};
+
+[[nodiscard]] std::string MakeWkt(const AllocationScenario& scenario, int index)
+{
+    const auto x = index % 90;
+    const auto y = index / 90 % 90;
+    if (scenario.geometryType == GeometryType::Point)
+    {
+        return fmt::format("POINT({} {})", x, y);
+    }
+
+    std::string coordinates;
+    for (int i = 0; i < scenario.verticesPerFeature; ++i)
+    {
+        // a closed ring for polygons, an open zigzag for lines
+        const auto isLast = i == scenario.verticesPerFeature - 1;
+        const auto dx = isLast && scenario.geometryType == GeometryType::Polygon ? 0. : 0.01 * i;
+        const auto dy = isLast && scenario.geometryType == GeometryType::Polygon ? 0. : 0.01 * (i % 2 + i / 2);
+        coordinates += fmt::format("{}{} {}", i == 0 ? "" : ", ", x + dx, y + dy);
+    }
+    return scenario.geometryType == GeometryType::Polygon ? 
+        fmt::format("POLYGON(({}))", coordinates) : fmt::format("LINESTRING({})", coordinates);
+}
+
+} // namespace
+
+class AllocationTest
+    : public DatabaseTestFixture
+    , public testing::WithParamInterface<std::tuple<AllocationScenario, DecodePipelineOptions>> {};
+
+INSTANTIATE_TEST_SUITE_P(Database, AllocationTest, testing::Combine(
+        testing::Values(
+            // attribute values are copied into the buffered features, that's most of the allocations of points
+            AllocationScenario{"PointsWithAttributes", "POINT", GeometryType::Point, 1, true, 
+                {.allocationsPerFeature = 14, .bytesPerFeature = 1536, .allocationsPerVertex = 14, .bytesPerVertex = 1536}},
+            AllocationScenario{"Lines", "LINESTRING", GeometryType::Line, 20, false, 
+                {.allocationsPerFeature = 9, .bytesPerFeature = 2048, .allocationsPerVertex = 0.5, .bytesPerVertex = 104}},
+            AllocationScenario{"Polygons", "POLYGON", GeometryType::Polygon, 20, false, 
+                {.allocationsPerFeature = 10, .bytesPerFeature = 2304, .allocationsPerVertex = 0.5, .bytesPerVertex = 116}}
+        ),
+        testing::Values(
+            DecodePipelineOptions{.threads = 0, .batchSize = 64},
+            DecodePipelineOptions{.threads = 2, .batchSize = 64}
+        )
+    ),
+    [](const auto& info)
+    {
+        return fmt::format("{}Threads{}", std::get<0>(info.param).name, std::get<1>(info.param).threads);
+    }
+);
+
+TEST_P(AllocationTest, AllocationsAreWithinBudget)
+{
+    const auto& [scenario, options] = GetParam();
+    auto table = CreateTable("allocations", {{"intAttribute", "INTEGER"}, {"doubleAttribute", "REAL"}, {"textAttribute", "TEXT"}});
+    table.AddGeometryColumn("geometry", scenario.spatialiteType);
+    for (int i = 0; i < FeaturesCount; ++i)
+    {
+        table.Insert(i, i * 0.5, fmt::format("text attribute of feature {}", i), ::Geometry{MakeWkt(scenario, i)});
+    }
+    InitializeDb();
+
+    auto& tableInfo = table.UpdateAndGetTableInfo(scenario.geometryType, Dimension::XY);
+    if (scenario.hasAttributes)
+    {
+        tableInfo.attributes = {
+            {"intAttribute", {ColumnType::Int64}},
+            {"doubleAttribute", {ColumnType::Double}},
+            {"textAttribute", {ColumnType::Text}}
+        };
+    }
+    DecodePipeline pipeline{options};
+    const auto read = [&] {
+        CountingFeature feature;
+        auto geometries = spatialiteDb->GetGeometries(tableInfo, mbr);
+        const auto features = pipeline.Decode(geometries);
+        for (const auto& bufferedFeature : features)
+        {
+            bufferedFeature.AddTo(feature);
+        }
+        return std::pair{features.size(), feature.vertices};
+    };
+
+    // the first request fills the page cache, the decode arena and the thread-local buffers
+    const auto [warmUpFeatures, warmUpVertices] = read();
+    ASSERT_EQ(warmUpFeatures, FeaturesCount);
+
+    AllocationCount count;
+    uint64_t vertices = 0;
+    {
+        AllocationCounter counter;
+        vertices = read().second;
+        count = counter.Get();
+    }
+    ASSERT_EQ(vertices, static_cast<uint64_t>(FeaturesCount * scenario.verticesPerFeature));
+
+    const auto perFeature = [](uint64_t value) { return static_cast<double>(value) / FeaturesCount; };
+    const auto perVertex = [vertices](uint64_t value) { return static_cast<double>(value) / static_cast<double>(vertices); };
+    const AllocationBudget measured{
+        perFeature(count.allocations), perFeature(count.bytes), perVertex(count.allocations), perVertex(count.bytes)};
+    std::cout << fmt::format(
+        "[ ALLOCS   ] {} allocations, {} bytes: {:.2f} allocations and {:.0f} bytes per feature, "
+        "{:.3f} allocations and {:.1f} bytes per vertex\n",
+        count.allocations, count.bytes, measured.allocationsPerFeature, measured.bytesPerFeature, 
+        measured.allocationsPerVertex, measured.bytesPerVertex);
+
+    EXPECT_LE(measured.allocationsPerFeature, scenario.budget.allocationsPerFeature);
+    EXPECT_LE(measured.bytesPerFeature, scenario.budget.bytesPerFeature);
+    EXPECT_LE(measured.allocationsPerVertex, scenario.budget.allocationsPerVertex);
+    EXPECT_LE(measured.bytesPerVertex, scenario.budget.bytesPerVertex);
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "BufferedFeature.h"
+#include "DatabaseTestFixture.h"
+#include "FeatureMock.h"
+
+#include <gmock/gmock.h>
+
+using SpatialiteDatasource::BufferedFeature;
+using SpatialiteDatasource::ColumnType;
+using SpatialiteDatasource::Dimension;
+using SpatialiteDatasource::GeometryType;
+using SpatialiteDatasource::Mbr;
+
+class BufferedFeatureTest : public DatabaseTestFixture {};
+
+TEST_F(BufferedFeatureTest, BufferedGeometriesAreAddedToFeature)
+{
+    auto table = InitializeDbWithGeometries({
+        "MULTILINESTRINGZ((5 6 3, 7 8 4), (9 1 5, 2 3 6, 4 5 7))",
+        "MULTILINESTRINGZ((1 2 3, 4 5 6))"
+    });
+    auto geometries = GetGeometries(GeometryType::MultiLine, Dimension::XYZ, table);
+
+    FeatureMock featureMock;
+    for (auto geometry : geometries)
+    {
+        BufferedFeature bufferedFeature{geometry.GetId()};
+        geometry.AddTo(bufferedFeature);
+        bufferedFeature.AddTo(featureMock);
+    }
+
+    const MapgetGeometries expectedGeometries{
+        {{5, 6, 3}, {7, 8, 4}},
+        {{9, 1, 5}, {2, 3, 6}, {4, 5, 7}},
+        {{1, 2, 3}, {4, 5, 6}}
+    };
+    ASSERT_EQ(featureMock.geometries.size(), expectedGeometries.size());
+    for (size_t i = 0; i < expectedGeometries.size(); ++i)
+    {
+        ASSERT_EQ(featureMock.geometries[i].size(), expectedGeometries[i].size());
+        for (size_t j = 0; j < expectedGeometries[i].size(); ++j)
+        {
+            EXPECT_DOUBLE_EQ(featureMock.geometries[i][j].x, expectedGeometries[i][j].x);
+            EXPECT_DOUBLE_EQ(featureMock.geometries[i][j].y, expectedGeometries[i][j].y);
+            EXPECT_DOUBLE_EQ(featureMock.geometries[i][j].z, expectedGeometries[i][j].z);
+        }
+    }
+    EXPECT_THAT(featureMock.types, testing::Each(GeometryType::MultiLine));
+    EXPECT_THAT(featureMock.initialCapacities, testing::ElementsAre(2, 3, 2));
+}
+
+TEST_F(BufferedFeatureTest, BufferedAttributesAreAddedToFeature)
+{
+    BufferedFeature bufferedFeature{1};
+    bufferedFeature.AddAttribute("intAttribute", int64_t{42});
+    bufferedFeature.AddAttribute("doubleAttribute", 6.66);
+    bufferedFeature.AddAttribute("stringAttribute", std::string_view{"value"});
+
+    FeatureMock featureMock;
+    {
+        using testing::TypedEq;
+        EXPECT_CALL(featureMock, AddAttribute("intAttribute", TypedEq<int64_t>(42))).Times(1);
+        EXPECT_CALL(featureMock, AddAttribute("doubleAttribute", TypedEq<double>(6.66))).Times(1);
+        EXPECT_CALL(featureMock, AddAttribute("stringAttribute", TypedEq<std::string_view>("value"))).Times(1);
+    }
+    bufferedFeature.AddTo(featureMock);
+    EXPECT_EQ(bufferedFeature.GetId(), 1);
+}
+
+TEST_F(BufferedFeatureTest, AnyGeometryIntersectingMbrIsEnough)
+{
+    constexpr Mbr TileMbr{0., 0., 10., 10.};
+    BufferedFeature bufferedFeature{1};
+    {
+        auto& geometry = bufferedFeature.AddGeometry(GeometryType::MultiLine, 2);
+        geometry.AddPoint({-5., 4.});
+        geometry.AddPoint({4., -5.});
+    }
+    EXPECT_FALSE(bufferedFeature.Intersects(TileMbr));
+
+    {
+        auto& geometry = bufferedFeature.AddGeometry(GeometryType::MultiLine, 2);
+        geometry.AddPoint({-5., 5.});
+        geometry.AddPoint({15., 5.});
+    }
+    EXPECT_TRUE(bufferedFeature.Intersects(TileMbr));
+}
@@ -23,6 +23,9 @@
 
 #include <gmock/gmock.h>
 
+#include <atomic>
+#include <thread>
+
 using namespace SpatialiteDatasource;
 
 TEST(ConfigLoaderTest, LoadsDatasourceOptionsFromConfig)
@@ -70,6 +73,161 @@ TEST(ConfigLoaderTest, WrongConfigFormatThrows)
     EXPECT_THROW((ConfigLoader{config, {}}), std::runtime_error);
 }
 
+TEST(ConfigLoaderTest, LayerOptionsOverrideGlobalOptions)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        global:
+          subPixelCulling:
+            minPixels: 2
+        layers:
+          - table: Roads
+            subPixelCulling:
+              minPixels: 0.5
+          - table: buildings
+    )");
+
+    const ConfigLoader loader{config, {}};
+    EXPECT_DOUBLE_EQ(loader.GetLayerOptions("roads").subPixelCullingPixels, 0.5);
+    EXPECT_DOUBLE_EQ(loader.GetLayerOptions("buildings").subPixelCullingPixels, 2.);
+    EXPECT_DOUBLE_EQ(loader.GetLayerOptions("not_configured").subPixelCullingPixels, 2.);
+}
+
+TEST(ConfigLoaderTest, ExactIntersectionIsDisabledByDefault)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        layers:
+          - table: roads
+            exactIntersection: true
+    )");
+
+    const ConfigLoader loader{config, {}};
+    EXPECT_TRUE(loader.GetLayerOptions("roads").exactIntersection);
+    EXPECT_FALSE(loader.GetLayerOptions("buildings").exactIntersection);
+}
+
+TEST(ConfigLoaderTest, ParsesPrecision)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        global:
+          precision:
+            gridPixels: 0.25
+        layers:
+          - table: buildings
+            precision:
+              gridPixels: 1
+              maxZoom: 14
+              dropZBelowZoom: 10
+    )");
+
+    const ConfigLoader loader{config, {}};
+    const auto buildings = loader.GetLayerOptions("buildings");
+    EXPECT_DOUBLE_EQ(buildings.quantizationGridPixels, 1.);
+    EXPECT_EQ(buildings.quantizationMaxZoom, 14);
+    EXPECT_EQ(buildings.dropZBelowZoom, 10);
+    EXPECT_DOUBLE_EQ(loader.GetLayerOptions("roads").quantizationGridPixels, 0.25);
+    EXPECT_EQ(loader.GetLayerOptions("roads").dropZBelowZoom, 0);
+}
+
+TEST(ConfigLoaderTest, ParsesClustering)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        layers:
+          - table: pois
+            clustering:
+              belowZoom: 12
+              cellPixels: 32
+          - table: wrong
+            clustering:
+              belowZoom: 12
+              cellPixels: 0
+    )");
+
+    const ConfigLoader loader{config, {}};
+    const auto pois = loader.GetLayerOptions("pois");
+    EXPECT_EQ(pois.clusterBelowZoom, 12);
+    EXPECT_DOUBLE_EQ(pois.clusterCellPixels, 32.);
+    EXPECT_EQ(loader.GetLayerOptions("roads").clusterBelowZoom, 0);
+    EXPECT_THROW(static_cast<void>(loader.GetLayerOptions("wrong")), std::runtime_error);
+}
+
+TEST(ConfigLoaderTest, ParsesBudget)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        global:
+          budget:
+            maxVertices: 1000
+        layers:
+          - table: roads
+            budget:
+              maxFeatures: 10
+              attribute: rank
+              ascending: true
+          - table: pois
+            budget:
+              importance: order
+    )");
+
+    const ConfigLoader loader{config, {}};
+    const auto roads = loader.GetLayerOptions("roads");
+    EXPECT_EQ(roads.maxFeatures, 10);
+    EXPECT_EQ(roads.maxVertices, 1000);
+    EXPECT_EQ(roads.importance, FeatureImportance::Attribute);
+    EXPECT_EQ(roads.importanceAttribute, "rank");
+    EXPECT_TRUE(roads.importanceAscending);
+    const auto buildings = loader.GetLayerOptions("buildings");
+    EXPECT_EQ(buildings.maxFeatures, 0);
+    EXPECT_EQ(buildings.importance, FeatureImportance::Size);
+    EXPECT_EQ(loader.GetLayerOptions("pois").importance, FeatureImportance::Order);
+}
+
+TEST(ConfigLoaderTest, MetricsAreBoundToLoopbackByDefault)
+{
+    const ConfigLoader defaultLoader{YAML::Load(R"(
+        map:
+          path: default/path
+        metrics:
+          port: 9100
+    )"), {}};
+    EXPECT_EQ(defaultLoader.GetMetricsOptions().host, "127.0.0.1");
+    EXPECT_EQ(defaultLoader.GetMetricsOptions().port, 9100);
+
+    const ConfigLoader loader{YAML::Load(R"(
+        map:
+          path: default/path
+        metrics:
+          host: 0.0.0.0
+          port: 9100
+    )"), {}};
+    EXPECT_EQ(loader.GetMetricsOptions().host, "0.0.0.0");
+}
+
+TEST(ConfigLoaderTest, AttributeImportanceCantBeInQueryOrder)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        layers:
+          - table: roads
+            budget:
+              maxFeatures: 10
+              importance: order
+              attribute: rank
+    )");
+
+    const ConfigLoader loader{config, {}};
+    EXPECT_THROW(static_cast<void>(loader.GetLayerOptions("roads")), std::runtime_error);
+}
+
 class ConfigLoaderTestFixture : public DatabaseTestFixture
 {
 protected:
@@ -192,6 +350,74 @@ TEST_F(ConfigLoaderTestFixture, LayersFromBothConfigAndDatabaseAreLoaded)
     EXPECT_TRUE(tablesInfo.contains("another_table"));
 }
 
+TEST_F(ConfigLoaderTestFixture, ZoomSourcesArePresentedAsTheirLayer)
+{
+    const auto tables = CreateEmptyGeometryTables("roads", "roads_lod1", "roads_lod2");
+
+    const auto loader = CreateConfigLoader(R"(
+        layers:
+        - table: roads
+          coordinatesScaling:
+            xy: 2
+          exactIntersection: true
+          zoomSources:
+          - table: roads_lod1
+            maxZoom: 12
+            key: base_id
+          - table: roads_lod2
+            maxZoom: 8
+            key: base_id
+    )");
+
+    const auto datasourceConfig = loader.GenerateDatasourceConfig(*spatialiteDb);
+    const auto& layers = datasourceConfig["layers"];
+    ASSERT_EQ(layers.size(), 1);
+    EXPECT_TRUE(layers.contains("roads"));
+
+    const auto tablesInfo = loader.LoadTablesInfo(*spatialiteDb);
+    ASSERT_EQ(tablesInfo.size(), 3);
+    EXPECT_EQ(tablesInfo.at("roads_lod1").name, "roads_lod1");
+    EXPECT_EQ(tablesInfo.at("roads_lod1").scaling.x, 2);
+    EXPECT_EQ(tablesInfo.at("roads_lod1").primaryKey, "base_id");
+
+    const auto options = loader.GetLayerOptions("roads");
+    ASSERT_EQ(options.zoomSources.size(), 2);
+    EXPECT_EQ(options.zoomSources[0].table, "roads_lod2");
+    EXPECT_EQ(options.zoomSources[0].maxZoom, 8);
+    EXPECT_EQ(options.zoomSources[1].table, "roads_lod1");
+    EXPECT_TRUE(loader.GetLayerOptions("roads_lod1").exactIntersection);
+}
+
+TEST(ConfigLoaderTest, ZoomSourceMustNotBeLayer)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        layers:
+          - table: roads
+            zoomSources:
+              - table: roads_lod1
+                maxZoom: 10
+                key: base_id
+          - table: roads_lod1
+    )");
+    EXPECT_THROW((ConfigLoader{config, {}}), std::runtime_error);
+}
+
+TEST(ConfigLoaderTest, ZoomSourceMustHaveKey)
+{
+    const auto config = YAML::Load(R"(
+        map:
+          path: default/path
+        layers:
+          - table: roads
+            zoomSources:
+              - table: roads_lod1
+                maxZoom: 10
+    )");
+    EXPECT_THROW((ConfigLoader{config, {}}), std::runtime_error);
+}
+
 TEST_F(ConfigLoaderTestFixture, ParsesScaling)
 {
     const auto tables = CreateEmptyGeometryTables("test_table");
@@ -350,3 +576,56 @@ TEST_F(ConfigLoaderTestFixture, LoadAttributesFromBothConfigAndDatabase)
     EXPECT_THAT(std::vector(keys.begin(), keys.end()), testing::UnorderedElementsAre(
         "intAttribute", "doubleAttribute", "stringAttribute", "blobAttribute", "my_attribute"));
 }
+
+TEST_F(ConfigLoaderTestFixture, LazyLayersAreLoadedOnFirstUse)
+{
+    CreateTableWithAttributes("test_table");
+    const auto loader = CreateConfigLoader(R"(
+        lazyLayers: true
+    )");
+    DatabasePool pool{GetDbPath(), 2};
+    auto lazyTablesInfo = loader.LoadLazyTablesInfo(*spatialiteDb, pool);
+    const auto tablesInfo = loader.LoadTablesInfo(*spatialiteDb);
+
+    ASSERT_EQ(lazyTablesInfo.size(), 1);
+    const auto& tableInfo = lazyTablesInfo.at("test_table").Get(pool);
+    auto expectedTableInfo = tablesInfo.at("test_table");
+    static_cast<void>(expectedTableInfo.GetSqlQuery());
+    EXPECT_EQ(tableInfo, expectedTableInfo);
+}
+
+TEST_F(ConfigLoaderTestFixture, LazyLayersAreLoadedOnStartupIfAuditFails)
+{
+    CreateTableWithAttributes("test_table");
+    const auto loader = CreateConfigLoader(R"(
+        lazyLayers: true
+        queryPlanAudit:
+          onFullScan: fail
+    )");
+    DatabasePool pool{GetDbPath(), 2};
+    const auto lazyTablesInfo = loader.LoadLazyTablesInfo(*spatialiteDb, pool);
+
+    ASSERT_EQ(lazyTablesInfo.size(), 1);
+    EXPECT_TRUE(lazyTablesInfo.at("test_table").IsLoaded());
+}
+
+TEST_F(ConfigLoaderTestFixture, LazyTableInfoIsLoadedOnce)
+{
+    InitializeDb();
+    DatabasePool pool{GetDbPath(), 2};
+    std::atomic<int> loads = 0;
+    LazyTableInfo lazyTableInfo{[&](const Database&) {
+        ++loads;
+        TableInfo tableInfo;
+        tableInfo.name = "test_table";
+        return tableInfo;
+    }};
+
+    std::vector<std::jthread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&] { EXPECT_EQ(lazyTableInfo.Get(pool).name, "test_table"); });
+    }
+    threads.clear();
+    EXPECT_EQ(loads, 1);
+}
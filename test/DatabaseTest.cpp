@@ -21,6 +21,8 @@
 #include "DatabaseTestFixture.h"
 #include "GeometryType.h"
 
+#include <gmock/gmock.h>
+#include <fmt/format.h>
 #include <spatialite/gg_const.h>
 #include <stdexcept>
 
@@ -68,6 +70,28 @@ TEST_F(SpatialiteDatabaseTest, TablesNamesAreReturned)
     EXPECT_EQ(tablesNames[0], table.name);
 }
 
+TEST_F(SpatialiteDatabaseTest, TablesMetadataIsReturned)
+{
+    const auto table = InitializeDbWithEmptyGeometryTable("my_table", "POINT", SpatialIndex::RTree);
+    const auto tablesMetadata = spatialiteDb->GetTablesMetadata();
+    ASSERT_EQ(tablesMetadata.size(), 1);
+    const auto& metadata = tablesMetadata[0];
+    EXPECT_EQ(metadata.tableName, table.name);
+    EXPECT_EQ(metadata.geometryColumn, table.GetGeometryColumnName());
+    EXPECT_EQ(metadata.geometryType, GAIA_POINT);
+    EXPECT_EQ(metadata.srid, Wgs84Srid);
+    EXPECT_EQ(metadata.spatialIndexEnabled, 1);
+    EXPECT_EQ(metadata.primaryKey, "id");
+}
+
+TEST_F(SpatialiteDatabaseTest, QueryPlanIsExplained)
+{
+    const auto table = InitializeDbWithEmptyGeometryTable("my_table", "POINT", SpatialIndex::None);
+    const auto plan = spatialiteDb->ExplainQueryPlan(fmt::format("SELECT * FROM {} WHERE id = 1", table.name));
+    ASSERT_FALSE(plan.empty());
+    EXPECT_THAT(plan[0], testing::HasSubstr(table.name));
+}
+
 TEST_F(SpatialiteDatabaseTest, EmptyViewDoesNotThrow)
 {
     auto table = InitializeDbWithEmptyGeometryTable("my_table", "POINT", SpatialIndex::None);
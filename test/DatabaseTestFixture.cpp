@@ -76,6 +76,16 @@ void DatabaseTestFixture::InitializeDb()
     spatialiteDb = std::make_unique<SpatialiteDatasource::Database>(testDb->GetPath());
 }
 
+[[nodiscard]] std::filesystem::path DatabaseTestFixture::GetDbPath()
+{
+    return testDb->GetPath();
+}
+
+void DatabaseTestFixture::Execute(const std::string& sql)
+{
+    testDb->Execute(sql);
+}
+
 [[nodiscard]] SpatialiteDatasource::GeometriesView DatabaseTestFixture::GetGeometries(
     SpatialiteDatasource::GeometryType geometryType, 
     SpatialiteDatasource::Dimension dimension, 
@@ -48,6 +48,10 @@ public:
 
     void InitializeDb();
 
+    [[nodiscard]] static std::filesystem::path GetDbPath();
+
+    static void Execute(const std::string& sql);
+
     [[nodiscard]] SpatialiteDatasource::GeometriesView GetGeometries(
         SpatialiteDatasource::GeometryType geometryType, 
         SpatialiteDatasource::Dimension dimension, 
@@ -0,0 +1,121 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "DatabaseTestFixture.h"
+#include "Deadline.h"
+
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+
+#include <atomic>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+/**
+ * @brief Step through all the rows of the geometries
+ * 
+ * @return Number of the rows
+ */
+size_t StepAll(GeometriesView& geometries)
+{
+    size_t rows = 0;
+    for (auto it = geometries.begin(); it != geometries.end(); ++it)
+    {
+        ++rows;
+    }
+    return rows;
+}
+
+} // namespace
+
+TEST(DeadlineTest, DeadlineExpiresWhenCancelled)
+{
+    std::atomic<bool> isCancelled{false};
+    const Deadline deadline{Deadline::Clock::time_point::max(), &isCancelled};
+    EXPECT_FALSE(deadline.IsExpired());
+
+    isCancelled = true;
+    EXPECT_TRUE(deadline.IsExpired());
+    EXPECT_TRUE(Deadline{Deadline::Clock::now()}.IsExpired());
+}
+
+TEST(DeadlineTest, ScopeRestoresPreviousDeadline)
+{
+    const Deadline outer{Deadline::Clock::time_point::max()};
+    const Deadline inner{Deadline::Clock::time_point::max()};
+    EXPECT_EQ(Deadline::Current(), nullptr);
+    {
+        const DeadlineScope outerScope{&outer};
+        {
+            const DeadlineScope innerScope{&inner};
+            EXPECT_EQ(Deadline::Current(), &inner);
+        }
+        EXPECT_EQ(Deadline::Current(), &outer);
+    }
+    EXPECT_EQ(Deadline::Current(), nullptr);
+}
+
+class DeadlineDatabaseTest : public DatabaseTestFixture
+{
+protected:
+    static constexpr size_t RowsCount = 1000;
+
+    Table CreatePoints()
+    {
+        std::vector<std::string> points;
+        points.reserve(RowsCount);
+        for (size_t i = 0; i < RowsCount; ++i)
+        {
+            points.push_back(fmt::format("POINT({} {})", i % 100, i / 100));
+        }
+        return InitializeDbWithGeometries(points);
+    }
+};
+
+TEST_F(DeadlineDatabaseTest, QueryIsInterruptedByExpiredDeadline)
+{
+    auto table = CreatePoints();
+    const Deadline deadline{Deadline::Clock::now()};
+    const DeadlineScope deadlineScope{&deadline};
+
+    auto geometries = GetGeometries(GeometryType::Point, Dimension::XY, table);
+    try
+    {
+        static_cast<void>(StepAll(geometries));
+        FAIL() << "The query wasn't interrupted";
+    }
+    catch (const SQLite::Exception& e)
+    {
+        EXPECT_EQ(e.getErrorCode(), SQLITE_INTERRUPT);
+    }
+}
+
+TEST_F(DeadlineDatabaseTest, QueryRunsToCompletionBeforeDeadline)
+{
+    auto table = CreatePoints();
+    const Deadline deadline{Deadline::Clock::time_point::max()};
+    const DeadlineScope deadlineScope{&deadline};
+
+    auto geometries = GetGeometries(GeometryType::Point, Dimension::XY, table);
+    EXPECT_EQ(StepAll(geometries), RowsCount);
+}
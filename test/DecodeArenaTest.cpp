@@ -0,0 +1,91 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "DecodeArena.h"
+
+#include <gtest/gtest.h>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+void AllocateStrings(DecodeArena& arena, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::pmr::string text{"a string that doesn't fit into the small string buffer", arena.GetResource()};
+    }
+}
+
+} // namespace
+
+TEST(DecodeArenaTest, WarmedUpArenaDoesNotAllocate)
+{
+    DecodeArena arena;
+    AllocateStrings(arena, 1000);
+    EXPECT_GT(arena.GetUpstreamAllocations(), 0);
+    const auto usedBytes = arena.GetUsedBytes();
+    EXPECT_GE(usedBytes, 1000 * 55);
+
+    arena.Reset();
+    EXPECT_EQ(arena.GetUsedBytes(), 0);
+    EXPECT_EQ(arena.GetHighWaterMark(), usedBytes);
+
+    AllocateStrings(arena, 1000);
+    EXPECT_EQ(arena.GetUpstreamAllocations(), 0);
+    EXPECT_EQ(arena.GetUsedBytes(), usedBytes);
+}
+
+TEST(DecodeArenaTest, HighWaterMarkIsTheLargestRequest)
+{
+    DecodeArena arena;
+    AllocateStrings(arena, 100);
+    const auto smallRequest = arena.GetUsedBytes();
+    arena.Reset();
+    AllocateStrings(arena, 200);
+    const auto largeRequest = arena.GetUsedBytes();
+    arena.Reset();
+    AllocateStrings(arena, 100);
+    arena.Reset();
+
+    EXPECT_GT(largeRequest, smallRequest);
+    EXPECT_EQ(arena.GetHighWaterMark(), largeRequest);
+}
+
+TEST(DecodeArenaTest, ArenasAreRecycledByThread)
+{
+    DecodeArena* outer = nullptr;
+    DecodeArena* nested = nullptr;
+    {
+        const auto outerLease = AcquireDecodeArena();
+        outer = &*outerLease;
+        AllocateStrings(*outerLease, 10);
+        const auto nestedLease = AcquireDecodeArena();
+        nested = &*nestedLease;
+        EXPECT_NE(nested, outer);
+    }
+    // the outer lease was released last, so it's taken first
+    const auto lease = AcquireDecodeArena();
+    EXPECT_EQ(&*lease, outer);
+    EXPECT_EQ(lease->GetUsedBytes(), 0);
+    const auto next = AcquireDecodeArena();
+    EXPECT_EQ(&*next, nested);
+}
@@ -0,0 +1,230 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "DecodePipeline.h"
+#include "DatabaseTestFixture.h"
+#include "FeatureMock.h"
+
+#include <gmock/gmock.h>
+
+using namespace SpatialiteDatasource;
+
+class DecodePipelineTest
+    : public DatabaseTestFixture
+    , public testing::WithParamInterface<DecodePipelineOptions> {};
+
+INSTANTIATE_TEST_SUITE_P(Database, DecodePipelineTest, testing::Values(
+        DecodePipelineOptions{.threads = 0, .batchSize = 8},
+        DecodePipelineOptions{.threads = 1, .batchSize = 1000},
+        DecodePipelineOptions{.threads = 1, .batchSize = 8},
+        DecodePipelineOptions{.threads = 4, .batchSize = 1}
+    ),
+    [](const auto& info)
+    {
+        return fmt::format("Threads{}Batch{}", info.param.threads, info.param.batchSize);
+    }
+);
+
+TEST_P(DecodePipelineTest, FeaturesAreDecodedInOrderOfRows)
+{
+    constexpr int RowsCount = 100;
+    auto table = CreateTable("table_with_attributes", {
+        {"intAttribute", "INTEGER"},
+        {"blobAttribute", "BLOB"}
+    });
+    table.AddGeometryColumn("geometry", "LINESTRING");
+    for (int i = 0; i < RowsCount; ++i)
+    {
+        table.Insert(i, Binary{"DEADBEEF"}, ::Geometry{fmt::format("LINESTRING({0} {0}, {1} {1})", i % 50, i % 50 + 1)});
+    }
+    InitializeDb();
+
+    auto& tableInfo = table.UpdateAndGetTableInfo(GeometryType::Line, Dimension::XY);
+    tableInfo.attributes = {
+        {"intAttribute", {ColumnType::Int64}},
+        {"blobAttribute", {ColumnType::Blob}}
+    };
+    auto geometries = spatialiteDb->GetGeometries(tableInfo, mbr);
+    DecodePipeline pipeline{GetParam()};
+    const auto features = pipeline.Decode(geometries);
+
+    ASSERT_EQ(features.size(), RowsCount);
+    for (int i = 0; i < RowsCount; ++i)
+    {
+        const auto& feature = features[i];
+        EXPECT_EQ(feature.GetId(), i + 1);
+
+        FeatureMock featureMock;
+        {
+            using testing::TypedEq;
+            EXPECT_CALL(featureMock, AddAttribute("intAttribute", TypedEq<int64_t>(i))).Times(1);
+            EXPECT_CALL(featureMock, AddAttribute("blobAttribute", TypedEq<std::string_view>("DEADBEEF"))).Times(1);
+        }
+        feature.AddTo(featureMock);
+        ASSERT_EQ(featureMock.geometries.size(), 1);
+        ASSERT_EQ(featureMock.geometries[0].size(), 2);
+        EXPECT_DOUBLE_EQ(featureMock.geometries[0][0].x, i % 50);
+        EXPECT_DOUBLE_EQ(featureMock.geometries[0][1].y, i % 50 + 1);
+    }
+}
+
+TEST_P(DecodePipelineTest, ScratchMemoryIsReusedBetweenRequests)
+{
+    auto table = CreateTable("table_with_text", {{"textAttribute", "TEXT"}});
+    table.AddGeometryColumn("geometry", "POINT");
+    for (int i = 0; i < 100; ++i)
+    {
+        table.Insert(fmt::format("a text attribute that doesn't fit into the small string buffer {}", i), 
+            ::Geometry{fmt::format("POINT({0} {0})", i % 50)});
+    }
+    InitializeDb();
+
+    auto& tableInfo = table.UpdateAndGetTableInfo(GeometryType::Point, Dimension::XY);
+    tableInfo.attributes = {{"textAttribute", {ColumnType::Text}}};
+    DecodePipeline pipeline{GetParam()};
+    for (int request = 0; request < 2; ++request)
+    {
+        auto geometries = spatialiteDb->GetGeometries(tableInfo, mbr);
+        DecodeStats stats;
+        const auto features = pipeline.Decode(geometries, {}, stats);
+        ASSERT_EQ(features.size(), 100);
+        if (request == 1)
+        {
+            EXPECT_EQ(stats.arenaAllocations, 0);
+        }
+    }
+}
+
+TEST_P(DecodePipelineTest, FeaturesSmallerThanLevelOfDetailAreCulled)
+{
+    auto table = CreateTable("table_with_lines", {});
+    table.AddGeometryColumn("geometry", "LINESTRING");
+    for (int i = 0; i < 50; ++i)
+    {
+        // every other line is shorter than the culling size in both directions
+        const auto length = i % 2 == 0 ? 0.1 : 2.;
+        table.Insert(::Geometry{fmt::format("LINESTRING({0} {0}, {1} {0})", i, i + length)});
+    }
+    InitializeDb();
+
+    auto& tableInfo = table.UpdateAndGetTableInfo(GeometryType::Line, Dimension::XY);
+    auto geometries = spatialiteDb->GetGeometries(tableInfo, mbr);
+    DecodePipeline pipeline{GetParam()};
+    LevelOfDetail levelOfDetail;
+    levelOfDetail.minFeatureSize = 1.;
+    DecodeStats stats;
+    const auto features = pipeline.Decode(geometries, levelOfDetail, stats);
+
+    ASSERT_EQ(features.size(), 25);
+    EXPECT_EQ(stats.culledFeatures, 25);
+    for (size_t i = 0; i < features.size(); ++i)
+    {
+        EXPECT_EQ(features[i].GetId(), static_cast<int>(i) * 2 + 2);
+    }
+}
+
+TEST_P(DecodePipelineTest, CoordinatesAreRoundedToGridAndDuplicatesCollapsed)
+{
+    std::vector<std::string> lines;
+    for (int i = 0; i < 20; ++i)
+    {
+        lines.push_back(fmt::format("LINESTRINGZ({0} 0.1 5, {0}.2 0.3 6, {0}.6 0.4 7, {0}.9 2.2 8)", i));
+    }
+    auto table = InitializeDbWithGeometries(lines);
+    auto geometries = GetGeometries(GeometryType::Line, Dimension::XYZ, table);
+    DecodePipeline pipeline{GetParam()};
+    LevelOfDetail levelOfDetail;
+    levelOfDetail.precision = {.gridSize = 1., .dropZ = true};
+    DecodeStats stats;
+    const auto features = pipeline.Decode(geometries, levelOfDetail, stats);
+
+    ASSERT_EQ(features.size(), 20);
+    for (int i = 0; i < 20; ++i)
+    {
+        FeatureMock featureMock;
+        features[i].AddTo(featureMock);
+        ASSERT_EQ(featureMock.geometries.size(), 1);
+        // the second point is rounded to the first one, the third and fourth to the next cells
+        EXPECT_THAT(featureMock.geometries[0], testing::ElementsAre(
+            mapget::Point{static_cast<double>(i), 0.},
+            mapget::Point{i + 1., 0.},
+            mapget::Point{i + 1., 2.}));
+    }
+}
+
+TEST_P(DecodePipelineTest, ReadStopsAtRowsLimit)
+{
+    std::vector<std::string> lines;
+    for (int i = 0; i < 100; ++i)
+    {
+        lines.push_back(fmt::format("LINESTRING({0} 0, {0} 1)", i % 50));
+    }
+    auto table = InitializeDbWithGeometries(lines);
+    auto geometries = GetGeometries(GeometryType::Line, Dimension::XY, table);
+    DecodePipeline pipeline{GetParam()};
+    LevelOfDetail levelOfDetail;
+    levelOfDetail.maxRows = 30;
+    DecodeStats stats;
+    const auto features = pipeline.Decode(geometries, levelOfDetail, stats);
+
+    ASSERT_EQ(features.size(), 30);
+    EXPECT_TRUE(stats.isReadTruncated);
+    for (size_t i = 0; i < features.size(); ++i)
+    {
+        EXPECT_EQ(features[i].GetId(), static_cast<int>(i) + 1);
+    }
+}
+
+TEST_P(DecodePipelineTest, CollapsedLinesKeepTwoPoints)
+{
+    auto table = InitializeDbWithGeometries({"LINESTRING(0.1 0.1, 0.2 0.2, 0.3 0.1)"});
+    auto geometries = GetGeometries(GeometryType::Line, Dimension::XY, table);
+    DecodePipeline pipeline{GetParam()};
+    LevelOfDetail levelOfDetail;
+    levelOfDetail.precision = {.gridSize = 1.};
+    DecodeStats stats;
+    const auto features = pipeline.Decode(geometries, levelOfDetail, stats);
+
+    ASSERT_EQ(features.size(), 1);
+    FeatureMock featureMock;
+    features[0].AddTo(featureMock);
+    ASSERT_EQ(featureMock.geometries.size(), 1);
+    EXPECT_THAT(featureMock.geometries[0], testing::ElementsAre(mapget::Point{0., 0.}, mapget::Point{0., 0.}));
+}
+
+TEST_P(DecodePipelineTest, CollapsedRingsKeepFourClosedPoints)
+{
+    auto table = InitializeDbWithGeometries({"POLYGON((0.1 0.1, 1.9 0.1, 1.9 0.2, 0.1 0.1))"});
+    auto geometries = GetGeometries(GeometryType::Polygon, Dimension::XY, table);
+    DecodePipeline pipeline{GetParam()};
+    LevelOfDetail levelOfDetail;
+    levelOfDetail.precision = {.gridSize = 1.};
+    DecodeStats stats;
+    const auto features = pipeline.Decode(geometries, levelOfDetail, stats);
+
+    ASSERT_EQ(features.size(), 1);
+    FeatureMock featureMock;
+    features[0].AddTo(featureMock);
+    ASSERT_EQ(featureMock.geometries.size(), 1);
+    // the second and third points are rounded to the same cell
+    EXPECT_THAT(featureMock.geometries[0], testing::ElementsAre(
+        mapget::Point{0., 0.}, mapget::Point{2., 0.}, mapget::Point{0., 0.}, mapget::Point{0., 0.}));
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "FeatureBudget.h"
+
+#include <gtest/gtest.h>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+[[nodiscard]] BufferedFeature CreateLine(int id, std::vector<mapget::Point> points, int64_t rank = 0)
+{
+    BufferedFeature feature{id};
+    auto& geometry = feature.AddGeometry(GeometryType::Line, points.size());
+    for (const auto& point : points)
+    {
+        geometry.AddPoint(point);
+    }
+    feature.AddAttribute("rank", rank);
+    return feature;
+}
+
+[[nodiscard]] std::vector<int> GetIds(const std::vector<const BufferedFeature*>& features)
+{
+    std::vector<int> ids;
+    for (const auto* feature : features)
+    {
+        ids.push_back(feature->GetId());
+    }
+    return ids;
+}
+
+} // namespace
+
+class FeatureBudgetTest : public testing::Test
+{
+protected:
+    BufferedFeatures buffer{
+        CreateLine(1, {{0., 0.}, {1., 1.}}, 3),
+        CreateLine(2, {{0., 0.}, {10., 10.}}, 1),
+        CreateLine(3, {{0., 0.}, {1., 0.}, {2., 0.}, {5., 0.}}, 2)
+    };
+    std::vector<const BufferedFeature*> features{&buffer[0], &buffer[1], &buffer[2]};
+};
+
+TEST_F(FeatureBudgetTest, FeaturesWithinBudgetAreKept)
+{
+    LayerOptions options;
+    EXPECT_FALSE(SelectFeaturesWithinBudget(features, options, GeometryType::Line).has_value());
+
+    options.maxFeatures = 3;
+    options.maxVertices = 8;
+    EXPECT_FALSE(SelectFeaturesWithinBudget(features, options, GeometryType::Line).has_value());
+}
+
+TEST_F(FeatureBudgetTest, LargestFeaturesAreKeptInOriginalOrder)
+{
+    LayerOptions options;
+    options.maxFeatures = 2;
+
+    const auto selected = SelectFeaturesWithinBudget(features, options, GeometryType::Line);
+    ASSERT_TRUE(selected.has_value());
+    EXPECT_EQ(GetIds(*selected), (std::vector{2, 3}));
+}
+
+TEST_F(FeatureBudgetTest, FeatureAboveVerticesBudgetIsSkipped)
+{
+    LayerOptions options;
+    options.maxVertices = 5;
+
+    // the 4 vertices of the second largest line don't fit after the largest one, the smallest line does
+    const auto selected = SelectFeaturesWithinBudget(features, options, GeometryType::Line);
+    ASSERT_TRUE(selected.has_value());
+    EXPECT_EQ(GetIds(*selected), (std::vector{1, 2}));
+}
+
+TEST_F(FeatureBudgetTest, FeaturesAreRankedByAttribute)
+{
+    LayerOptions options;
+    options.maxFeatures = 1;
+    options.importance = FeatureImportance::Attribute;
+    options.importanceAttribute = "rank";
+
+    const auto highest = SelectFeaturesWithinBudget(features, options, GeometryType::Line);
+    ASSERT_TRUE(highest.has_value());
+    EXPECT_EQ(GetIds(*highest), (std::vector{1}));
+
+    options.importanceAscending = true;
+    const auto lowest = SelectFeaturesWithinBudget(features, options, GeometryType::Line);
+    ASSERT_TRUE(lowest.has_value());
+    EXPECT_EQ(GetIds(*lowest), (std::vector{2}));
+}
+
+TEST_F(FeatureBudgetTest, FirstFeaturesAreKeptInQueryOrder)
+{
+    LayerOptions options;
+    options.maxFeatures = 2;
+    options.importance = FeatureImportance::Order;
+
+    const auto selected = SelectFeaturesWithinBudget(features, options, GeometryType::Line);
+    ASSERT_TRUE(selected.has_value());
+    EXPECT_EQ(GetIds(*selected), (std::vector<int>{1, 2}));
+}
@@ -26,6 +26,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <optional>
+
 using MapgetGeometry = std::vector<mapget::Point>;
 using MapgetGeometries = std::vector<MapgetGeometry>;
 
@@ -50,12 +52,12 @@ struct Attribute
 
 struct FeatureMock : SpatialiteDatasource::IFeature
 {
-    std::unique_ptr<SpatialiteDatasource::IGeometry> AddGeometry(
+    SpatialiteDatasource::IGeometry& AddGeometry(
         SpatialiteDatasource::GeometryType type, size_t initialCapacity) override
     {
         types.push_back(type);
         initialCapacities.emplace_back(initialCapacity);
-        return std::make_unique<GeometryMock>(geometries.emplace_back());
+        return lastGeometry.emplace(geometries.emplace_back());
     }
 
     void AddGeometries(SpatialiteDatasource::GeometriesView& geometries)
@@ -73,4 +75,5 @@ struct FeatureMock : SpatialiteDatasource::IFeature
     MapgetGeometries geometries;
     std::vector<SpatialiteDatasource::GeometryType> types;
     std::vector<size_t> initialCapacities;
+    std::optional<GeometryMock> lastGeometry;
 };
@@ -20,10 +20,14 @@
 
 #include "DatabaseTestFixture.h"
 #include "FeatureMock.h"
+#include "GeometriesView.h"
 
 #include <gmock/gmock.h>
 #include <boost/algorithm/string/case_conv.hpp>
 
+#include <array>
+#include <cstring>
+
 using SpatialiteDatasource::SpatialIndex;
 
 struct GeometryTestCase
@@ -206,4 +210,24 @@ TEST_P(SpatialiteDatabaseGeometriesTest, GeometriesAreCreated)
     EXPECT_THAT(featureMock.initialCapacities,
         testing::ElementsAreArray(std::views::transform(
             geometries.expectedGeometries, [](const auto& v) { return v.size(); })));
-}
\ No newline at end of file
+}
+TEST(GeometriesTest, MbrIsReadFromBlobHeader)
+{
+    // header of a little endian blob: start, endianness, SRID, MBR, MBR end
+    std::array<unsigned char, 39> blob{};
+    blob[1] = 0x01;
+    const std::array<double, 4> mbr{1., 2., 3., 4.};
+    std::memcpy(blob.data() + 6, mbr.data(), sizeof(mbr));
+    blob[38] = 0x7C;
+
+    const auto blobMbr = SpatialiteDatasource::GetBlobMbr(blob.data(), static_cast<int>(blob.size()));
+    ASSERT_TRUE(blobMbr.has_value());
+    EXPECT_DOUBLE_EQ(blobMbr->xmin, 1.);
+    EXPECT_DOUBLE_EQ(blobMbr->ymin, 2.);
+    EXPECT_DOUBLE_EQ(blobMbr->xmax, 3.);
+    EXPECT_DOUBLE_EQ(blobMbr->ymax, 4.);
+
+    blob[38] = 0x00;
+    EXPECT_FALSE(SpatialiteDatasource::GetBlobMbr(blob.data(), static_cast<int>(blob.size())).has_value());
+    EXPECT_FALSE(SpatialiteDatasource::GetBlobMbr(blob.data(), 10).has_value());
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "GeometryIntersection.h"
+
+#include <gtest/gtest.h>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+constexpr Mbr TileMbr{0., 0., 10., 10.};
+
+} // namespace
+
+TEST(GeometryIntersectionTest, PointsOnBordersIntersect)
+{
+    EXPECT_TRUE(PointsIntersect({{10., 5.}}, TileMbr));
+    EXPECT_TRUE(PointsIntersect({{-1., -1.}, {5., 5.}}, TileMbr));
+    EXPECT_FALSE(PointsIntersect({{-1., 5.}, {11., 5.}}, TileMbr));
+    EXPECT_FALSE(PointsIntersect({}, TileMbr));
+}
+
+TEST(GeometryIntersectionTest, LineCrossingTileIntersects)
+{
+    // both ends are outside, the segment crosses the tile
+    EXPECT_TRUE(LineIntersects({{-5., 5.}, {15., 5.}}, TileMbr));
+    EXPECT_TRUE(LineIntersects({{-5., 15.}, {15., -5.}}, TileMbr));
+    // the segment touches the corner
+    EXPECT_TRUE(LineIntersects({{-5., 5.}, {5., -5.}}, TileMbr));
+}
+
+TEST(GeometryIntersectionTest, DiagonalLineNearCornerDoesNotIntersect)
+{
+    // the MBR of the line covers the tile corner, but the line passes by it
+    EXPECT_FALSE(LineIntersects({{-5., 4.}, {4., -5.}}, TileMbr));
+    EXPECT_FALSE(LineIntersects({{8., 20.}, {20., 8.}}, TileMbr));
+    // all segments are beyond the same side
+    EXPECT_FALSE(LineIntersects({{-5., -5.}, {-1., 20.}, {-2., 30.}}, TileMbr));
+}
+
+TEST(GeometryIntersectionTest, PolygonContainingTileIntersects)
+{
+    EXPECT_TRUE(PolygonIntersects({{-5., -5.}, {15., -5.}, {15., 15.}, {-5., 15.}}, TileMbr));
+    EXPECT_TRUE(PolygonIntersects({{2., 2.}, {3., 2.}, {3., 3.}}, TileMbr));
+}
+
+TEST(GeometryIntersectionTest, PolygonAroundTileCornerDoesNotIntersect)
+{
+    // a triangle next to the corner, its MBR covers the corner
+    EXPECT_FALSE(PolygonIntersects({{-5., 4.}, {-5., -5.}, {4., -5.}}, TileMbr));
+    // the closing edge crosses the tile
+    EXPECT_TRUE(PolygonIntersects({{-5., 5.}, {-5., -5.}, {15., -5.}, {15., 5.}}, TileMbr));
+}
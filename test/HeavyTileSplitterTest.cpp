@@ -0,0 +1,160 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "HeavyTileSplitter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+const Mbr TileMbr{0., 0., 10., 10.};
+constexpr uint16_t Zoom = 10;
+
+BufferedFeature CreatePointFeature(int id, double x, double y)
+{
+    BufferedFeature feature{id};
+    feature.AddGeometry(GeometryType::Point, 1).AddPoint({x, y});
+    return feature;
+}
+
+/**
+ * @brief Features on a 11x11 grid with the step 1, including the points on the MBR borders
+ */
+BufferedFeatures ReadGridFeatures(const Mbr& mbr)
+{
+    BufferedFeatures features;
+    for (int x = 0; x <= 10; ++x)
+    {
+        for (int y = 0; y <= 10; ++y)
+        {
+            if (x >= mbr.xmin && x <= mbr.xmax && y >= mbr.ymin && y <= mbr.ymax)
+                features.push_back(CreatePointFeature(x * 100 + y, x, y));
+        }
+    }
+    return features;
+}
+
+std::vector<int> GetSortedIds(const BufferedFeatures& features)
+{
+    std::vector<int> ids;
+    for (const auto& feature : features)
+        ids.push_back(feature.GetId());
+    std::ranges::sort(ids);
+    return ids;
+}
+
+} // namespace
+
+TEST(MbrTest, SplitCoversMbr)
+{
+    const auto parts = Split({1., 2., 5., 4.}, 2);
+    ASSERT_EQ(parts.size(), 4);
+    EXPECT_DOUBLE_EQ(parts[0].xmin, 1.);
+    EXPECT_DOUBLE_EQ(parts[0].xmax, 3.);
+    EXPECT_DOUBLE_EQ(parts[0].ymax, 3.);
+    EXPECT_DOUBLE_EQ(parts[3].xmin, 3.);
+    EXPECT_DOUBLE_EQ(parts[3].ymin, 3.);
+    EXPECT_DOUBLE_EQ(parts[3].xmax, 5.);
+    EXPECT_DOUBLE_EQ(parts[3].ymax, 4.);
+}
+
+TEST(HeavyTileSplitterTest, TileIsReadAtOnceIfSplittingIsDisabled)
+{
+    std::atomic<int> reads = 0;
+    HeavyTileSplitter splitter{{}, 2, [&](const TableInfo&, const Mbr& mbr, uint16_t) {
+        ++reads;
+        return ReadGridFeatures(mbr);
+    }};
+
+    TableInfo tableInfo;
+    tableInfo.name = "table";
+    EXPECT_EQ(splitter.Read(tableInfo, TileMbr, Zoom).size(), 121);
+    EXPECT_EQ(splitter.Read(tableInfo, TileMbr, Zoom).size(), 121);
+    EXPECT_EQ(reads, 2);
+}
+
+TEST(HeavyTileSplitterTest, HeavyTileIsSplitAndFeaturesAreDeduplicated)
+{
+    std::atomic<int> reads = 0;
+    HeavyTileSplitter splitter{{.minFeatures = 100, .splitGrid = 2}, 2, [&](const TableInfo&, const Mbr& mbr, uint16_t) {
+        ++reads;
+        return ReadGridFeatures(mbr);
+    }};
+
+    TableInfo tableInfo;
+    tableInfo.name = "table";
+    // No history for the first request
+    const auto expected = GetSortedIds(splitter.Read(tableInfo, TileMbr, Zoom));
+    EXPECT_EQ(reads, 1);
+    EXPECT_DOUBLE_EQ(splitter.EstimateFeatures(tableInfo.name, TileMbr), 121.);
+
+    // Features on the split lines are returned by several parts
+    const auto features = splitter.Read(tableInfo, TileMbr, Zoom);
+    EXPECT_EQ(reads, 5);
+    EXPECT_EQ(GetSortedIds(features), expected);
+}
+
+TEST(HeavyTileSplitterTest, LightTileIsNotSplit)
+{
+    std::atomic<int> reads = 0;
+    HeavyTileSplitter splitter{{.minFeatures = 100, .splitGrid = 2}, 2, [&](const TableInfo&, const Mbr& mbr, uint16_t) {
+        ++reads;
+        return ReadGridFeatures(mbr);
+    }};
+
+    TableInfo tableInfo;
+    tableInfo.name = "table";
+    static_cast<void>(splitter.Read(tableInfo, TileMbr, Zoom));
+    // A quarter of the area is expected to have ~30 features
+    static_cast<void>(splitter.Read(tableInfo, {0., 0., 5., 5.}, Zoom));
+    EXPECT_EQ(reads, 2);
+}
+
+TEST(HeavyTileSplitterTest, PartsAreReadByBoundedWorkers)
+{
+    for (const size_t threads : {0, 1})
+    {
+        std::atomic<int> reads = 0;
+        std::atomic<int> running = 0;
+        std::atomic<int> maxRunning = 0;
+        HeavyTileSplitter splitter{{.minFeatures = 100, .splitGrid = 3}, threads, [&](const TableInfo&, const Mbr& mbr, uint16_t) {
+            const auto current = ++running;
+            for (auto max = maxRunning.load(); current > max && !maxRunning.compare_exchange_weak(max, current);) {}
+            ++reads;
+            auto features = ReadGridFeatures(mbr);
+            --running;
+            return features;
+        }};
+
+        TableInfo tableInfo;
+        tableInfo.name = "table";
+        const auto expected = GetSortedIds(splitter.Read(tableInfo, TileMbr, Zoom));
+        EXPECT_EQ(GetSortedIds(splitter.Read(tableInfo, TileMbr, Zoom)), expected);
+        EXPECT_EQ(reads, 10);
+        // the calling thread and the workers
+        EXPECT_LE(maxRunning, static_cast<int>(threads) + 1);
+    }
+}
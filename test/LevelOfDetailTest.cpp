@@ -0,0 +1,149 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "LevelOfDetail.h"
+
+#include <gtest/gtest.h>
+
+using namespace SpatialiteDatasource;
+
+TEST(LevelOfDetailTest, PixelSizeHalvesWithEveryZoomLevel)
+{
+    EXPECT_DOUBLE_EQ(GetPixelSize(0), 180. / 256.);
+    EXPECT_DOUBLE_EQ(GetPixelSize(1), 90. / 256.);
+    EXPECT_DOUBLE_EQ(GetPixelSize(10), GetPixelSize(11) * 2.);
+}
+
+TEST(LevelOfDetailTest, FeaturesSmallerThanPixelsAreCulled)
+{
+    TableInfo tableInfo;
+    tableInfo.geometryType = GeometryType::Line;
+    const auto levelOfDetail = GetLevelOfDetail({.subPixelCullingPixels = 1.}, tableInfo, 10);
+    const auto pixel = GetPixelSize(10);
+
+    EXPECT_TRUE(levelOfDetail.IsCulled({0., 0., pixel / 2., pixel / 2.}));
+    EXPECT_FALSE(levelOfDetail.IsCulled({0., 0., pixel * 2., pixel / 2.}));
+    EXPECT_FALSE(levelOfDetail.IsCulled({0., 0., pixel / 2., pixel * 2.}));
+}
+
+TEST(LevelOfDetailTest, PointsAreNeverCulled)
+{
+    TableInfo tableInfo;
+    tableInfo.geometryType = GeometryType::Point;
+    const auto levelOfDetail = GetLevelOfDetail({.subPixelCullingPixels = 1.}, tableInfo, 10);
+
+    EXPECT_FALSE(levelOfDetail.IsCulled({1., 1., 1., 1.}));
+}
+
+TEST(LevelOfDetailTest, CullingIsDisabledByDefault)
+{
+    TableInfo tableInfo;
+    tableInfo.geometryType = GeometryType::Polygon;
+    const auto levelOfDetail = GetLevelOfDetail({}, tableInfo, 20);
+
+    EXPECT_FALSE(levelOfDetail.IsCulled({1., 1., 1., 1.}));
+}
+
+TEST(LevelOfDetailTest, CoordinatesAreQuantizedUpToMaxZoom)
+{
+    TableInfo tableInfo;
+    const LayerOptions options{.quantizationGridPixels = 0.5, .quantizationMaxZoom = 14};
+
+    EXPECT_DOUBLE_EQ(GetLevelOfDetail(options, tableInfo, 10).precision.gridSize, GetPixelSize(10) / 2.);
+    EXPECT_DOUBLE_EQ(GetLevelOfDetail(options, tableInfo, 14).precision.gridSize, GetPixelSize(14) / 2.);
+    EXPECT_FALSE(GetLevelOfDetail(options, tableInfo, 15).precision.IsQuantized());
+    EXPECT_FALSE(GetLevelOfDetail({}, tableInfo, 10).precision.IsQuantized());
+}
+
+TEST(LevelOfDetailTest, ZIsDroppedBelowZoom)
+{
+    TableInfo tableInfo;
+    const LayerOptions options{.dropZBelowZoom = 12};
+
+    EXPECT_TRUE(GetLevelOfDetail(options, tableInfo, 11).precision.dropZ);
+    EXPECT_FALSE(GetLevelOfDetail(options, tableInfo, 12).precision.dropZ);
+    EXPECT_FALSE(GetLevelOfDetail({}, tableInfo, 0).precision.dropZ);
+}
+
+TEST(LevelOfDetailTest, OnlyPointsAreClusteredBelowZoom)
+{
+    TableInfo tableInfo;
+    tableInfo.geometryType = GeometryType::MultiPoint;
+    const LayerOptions options{.clusterBelowZoom = 10, .clusterCellPixels = 32.};
+
+    EXPECT_DOUBLE_EQ(GetLevelOfDetail(options, tableInfo, 9).clusterCellSize, GetPixelSize(9) * 32.);
+    EXPECT_DOUBLE_EQ(GetLevelOfDetail(options, tableInfo, 10).clusterCellSize, 0.);
+    EXPECT_FALSE(GetLevelOfDetail(options, tableInfo, 9).NeedsAttributes());
+    EXPECT_TRUE(GetLevelOfDetail(options, tableInfo, 10).NeedsAttributes());
+
+    tableInfo.geometryType = GeometryType::Line;
+    EXPECT_DOUBLE_EQ(GetLevelOfDetail(options, tableInfo, 9).clusterCellSize, 0.);
+}
+
+TEST(LevelOfDetailTest, ReadStopsAtBudgetInQueryOrder)
+{
+    TableInfo tableInfo;
+    const LayerOptions options{.maxFeatures = 10, .maxVertices = 100, .importance = FeatureImportance::Order};
+    const auto levelOfDetail = GetLevelOfDetail(options, tableInfo, 10);
+
+    EXPECT_FALSE(levelOfDetail.IsReadLimitReached(9, 99));
+    EXPECT_TRUE(levelOfDetail.IsReadLimitReached(10, 0));
+    EXPECT_TRUE(levelOfDetail.IsReadLimitReached(0, 100));
+    EXPECT_FALSE(GetLevelOfDetail({}, tableInfo, 10).IsReadLimitReached(1000000, 1000000));
+}
+
+TEST(LevelOfDetailTest, ReadOfImportantFeaturesStopsAtMultipleOfBudget)
+{
+    TableInfo tableInfo;
+    const auto levelOfDetail = GetLevelOfDetail({.maxFeatures = 10}, tableInfo, 10);
+
+    EXPECT_EQ(levelOfDetail.maxRows, 10 * ImportanceReadFactor);
+    EXPECT_EQ(levelOfDetail.maxVertices, 0);
+}
+
+TEST(LevelOfDetailTest, ReadOfClusteredPointsIsNotLimited)
+{
+    TableInfo tableInfo;
+    tableInfo.geometryType = GeometryType::Point;
+    const LayerOptions options{.clusterBelowZoom = 10, .clusterCellPixels = 32., .maxFeatures = 10, .maxVertices = 100};
+
+    const auto clustered = GetLevelOfDetail(options, tableInfo, 9);
+    EXPECT_GT(clustered.clusterCellSize, 0.);
+    EXPECT_FALSE(clustered.IsReadLimitReached(1000000, 1000000));
+    EXPECT_TRUE(GetLevelOfDetail(options, tableInfo, 10).IsReadLimitReached(1000000, 1000000));
+}
+
+TEST(LevelOfDetailTest, ReadLimitsOnlyApplyToSingleTileReads)
+{
+    TableInfo tableInfo;
+    const LayerOptions options{.maxFeatures = 10, .maxVertices = 100, .importance = FeatureImportance::Order};
+    const auto tileSize = GetPixelSize(10) * TileSizePixels;
+
+    const auto tile = GetReadLevelOfDetail(options, tableInfo, {1., 2., 1. + tileSize, 2. + tileSize}, 10);
+    EXPECT_EQ(tile.maxRows, 10);
+    EXPECT_EQ(tile.maxVertices, 100);
+
+    // batched tiles and parts of a split tile are trimmed per tile by the budget
+    const auto batch = GetReadLevelOfDetail(options, tableInfo, {0., 0., tileSize * 2., tileSize}, 10);
+    EXPECT_FALSE(batch.IsReadLimitReached(1000000, 1000000));
+    const auto part = GetReadLevelOfDetail(options, tableInfo, {0., 0., tileSize / 2., tileSize / 2.}, 10);
+    EXPECT_FALSE(part.IsReadLimitReached(1000000, 1000000));
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Metrics.h"
+
+#include <gmock/gmock.h>
+
+using namespace SpatialiteDatasource;
+using namespace std::chrono_literals;
+using testing::HasSubstr;
+
+TEST(MetricsTest, HistogramBucketsAreCumulative)
+{
+    LatencyHistogram histogram;
+    histogram.Observe(500us);
+    histogram.Observe(3ms);
+    histogram.Observe(1min);
+
+    std::string out;
+    histogram.Write(out, "latency", "layer=\"roads\"");
+    EXPECT_THAT(out, HasSubstr("latency_bucket{layer=\"roads\",le=\"0.001\"} 1\n"));
+    EXPECT_THAT(out, HasSubstr("latency_bucket{layer=\"roads\",le=\"0.0025\"} 1\n"));
+    EXPECT_THAT(out, HasSubstr("latency_bucket{layer=\"roads\",le=\"0.005\"} 2\n"));
+    EXPECT_THAT(out, HasSubstr("latency_bucket{layer=\"roads\",le=\"30\"} 2\n"));
+    EXPECT_THAT(out, HasSubstr("latency_bucket{layer=\"roads\",le=\"+Inf\"} 3\n"));
+    EXPECT_THAT(out, HasSubstr("latency_sum{layer=\"roads\"} 60.0035\n"));
+    EXPECT_THAT(out, HasSubstr("latency_count{layer=\"roads\"} 3\n"));
+}
+
+TEST(MetricsTest, MetricsAreFormattedPerLayer)
+{
+    DatasourceMetrics metrics;
+    metrics.tileRequests = 5;
+    metrics.locateMisses = 2;
+    metrics.retriedTileReads = 1;
+    auto& roads = metrics.layers["roads"];
+    roads.rows = 10;
+    roads.culledFeatures = 4;
+    roads.truncatedTiles = 1;
+    roads.truncatedReads = 3;
+    roads.interruptedQueries = 2;
+    roads.vertices = 100;
+    roads.clusters = 6;
+    roads.queryLatency.Observe(20ms);
+    roads.ObserveDecodeArenaBytes(4096);
+    roads.ObserveDecodeArenaBytes(2048);
+
+    const auto out = FormatMetrics(metrics, {{"roads", 7}}, {.usedBytes = 1024, .hits = 3, .misses = 4});
+    EXPECT_THAT(out, HasSubstr("# TYPE spatialite_datasource_tile_requests_total counter\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_tile_requests_total 5\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_retried_tile_reads_total 1\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_locate_misses_total 2\n"));
+    EXPECT_THAT(out, HasSubstr("# TYPE spatialite_datasource_query_seconds histogram\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_query_seconds_count{layer=\"roads\"} 1\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_rows_total{layer=\"roads\"} 10\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_culled_features_total{layer=\"roads\"} 4\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_truncated_tiles_total{layer=\"roads\"} 1\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_truncated_reads_total{layer=\"roads\"} 3\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_interrupted_queries_total{layer=\"roads\"} 2\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_vertices_total{layer=\"roads\"} 100\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_clusters_total{layer=\"roads\"} 6\n"));
+    EXPECT_THAT(out, HasSubstr("# TYPE spatialite_datasource_decode_arena_high_water_bytes gauge\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_decode_arena_high_water_bytes{layer=\"roads\"} 4096\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_locatable_features{layer=\"roads\"} 7\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_page_cache_used_bytes 1024\n"));
+    EXPECT_THAT(out, HasSubstr("# TYPE spatialite_datasource_page_cache_misses_total counter\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_page_cache_hits_total 3\n"));
+    EXPECT_THAT(out, HasSubstr("spatialite_datasource_page_cache_misses_total 4\n"));
+}
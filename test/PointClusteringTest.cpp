@@ -0,0 +1,73 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "PointClustering.h"
+
+#include <gtest/gtest.h>
+
+using namespace SpatialiteDatasource;
+
+TEST(PointClusteringTest, PointsOfCellAreMergedIntoMean)
+{
+    PointClusterGrid grid{10.};
+    grid.Add({1., 1.});
+    grid.Add({3., 5.});
+    grid.Add({15., 1.});
+    grid.Add({2., 3.});
+
+    const auto clusters = grid.GetClusters();
+    ASSERT_EQ(clusters.size(), 2);
+    EXPECT_EQ(clusters[0].count, 3);
+    EXPECT_DOUBLE_EQ(clusters[0].center.x, 2.);
+    EXPECT_DOUBLE_EQ(clusters[0].center.y, 3.);
+    EXPECT_EQ(clusters[1].count, 1);
+    EXPECT_DOUBLE_EQ(clusters[1].center.x, 15.);
+    EXPECT_EQ(grid.GetPointsCount(), 4);
+}
+
+TEST(PointClusteringTest, NegativeCoordinatesAreBinnedByFloor)
+{
+    PointClusterGrid grid{10.};
+    grid.Add({-1., -1.});
+    grid.Add({1., 1.});
+    grid.Add({-9., -9.});
+
+    const auto clusters = grid.GetClusters();
+    ASSERT_EQ(clusters.size(), 2);
+    EXPECT_EQ(clusters[0].count, 2);
+    EXPECT_DOUBLE_EQ(clusters[0].center.x, -5.);
+    EXPECT_EQ(clusters[1].count, 1);
+}
+
+TEST(PointClusteringTest, ClusterIdIsStablePerTileAndCell)
+{
+    PointClusterGrid grid{10.};
+    grid.Add({1., 1.});
+    grid.Add({15., 1.});
+    const auto clusters = grid.GetClusters();
+    ASSERT_EQ(clusters.size(), 2);
+
+    const auto id = GetClusterId(42, clusters[0].cell);
+    EXPECT_LT(id, 0);
+    EXPECT_EQ(id, GetClusterId(42, clusters[0].cell));
+    EXPECT_NE(id, GetClusterId(42, clusters[1].cell));
+    EXPECT_NE(id, GetClusterId(43, clusters[0].cell));
+}
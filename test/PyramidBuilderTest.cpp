@@ -0,0 +1,133 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "DatabaseTestFixture.h"
+#include "PyramidBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+using namespace SpatialiteDatasource;
+
+class PyramidBuilderTest : public DatabaseTestFixture
+{
+public:
+    [[nodiscard]] std::filesystem::path BuildPyramid(const std::vector<std::string>& tables, const std::vector<uint16_t>& maxZooms)
+    {
+        const auto pyramidPath = std::filesystem::temp_directory_path() / "pyramid-builder-test.sqlite";
+        SpatialiteDatasource::BuildPyramid({
+            .mapPath = GetDbPath(), 
+            .pyramidPath = pyramidPath, 
+            .tables = tables, 
+            .maxZooms = maxZooms});
+        return pyramidPath;
+    }
+
+    /**
+     * @brief Get the blob sizes of the table geometries by their ids
+     */
+    [[nodiscard]] static std::map<int, size_t> GetBlobSizes(const Database& db, const TableInfo& tableInfo)
+    {
+        std::map<int, size_t> sizes;
+        auto geometries = db.GetGeometries(tableInfo, {-180, -90, 180, 90});
+        for (const auto& geometry : geometries)
+        {
+            sizes[geometry.GetId()] = geometry.GetBlobSize();
+        }
+        return sizes;
+    }
+};
+
+TEST_F(PyramidBuilderTest, LevelsAreSimplifiedAndKeepPrimaryKeys)
+{
+    auto table = CreateTable("roads", {{"name", "TEXT"}});
+    table.AddGeometryColumn("geometry", "LINESTRING");
+    table.CreateSpatialIndex(SpatialIndex::RTree);
+    table.Insert("wiggly", ::Geometry{"LINESTRING(0 0, 1 0.001, 2 0, 3 0.001, 4 0)"});
+    table.Insert("straight", ::Geometry{"LINESTRING(10 10, 20 20)"});
+    InitializeDb();
+
+    const auto pyramidPath = BuildPyramid({"roads"}, {10, 4});
+    const Database pyramidDb{pyramidPath, GetDbPath()};
+
+    const auto levels = pyramidDb.GetPyramidLevels();
+    ASSERT_EQ(levels.size(), 2);
+    EXPECT_EQ(levels[0].table, "roads");
+    EXPECT_EQ(levels[0].levelTable, GetPyramidLevelTableName("roads", 4));
+    EXPECT_EQ(levels[0].maxZoom, 4);
+    EXPECT_EQ(levels[1].levelTable, GetPyramidLevelTableName("roads", 10));
+    EXPECT_EQ(levels[1].maxZoom, 10);
+
+    const TableInfo coarseInfo{levels[0].levelTable, pyramidDb};
+    const TableInfo fineInfo{levels[1].levelTable, pyramidDb};
+    EXPECT_EQ(coarseInfo.primaryKey, "id");
+    EXPECT_EQ(coarseInfo.spatialIndex, SpatialIndex::RTree);
+
+    const auto originalSizes = GetBlobSizes(*spatialiteDb, table.UpdateAndGetTableInfo(GeometryType::Line, Dimension::XY));
+    const auto coarseSizes = GetBlobSizes(pyramidDb, coarseInfo);
+    const auto fineSizes = GetBlobSizes(pyramidDb, fineInfo);
+    ASSERT_EQ(coarseSizes.size(), 2);
+    ASSERT_EQ(fineSizes.size(), 2);
+    // the wiggles are below a pixel of zoom level 4, but above a pixel of zoom level 10
+    EXPECT_LT(coarseSizes.at(1), originalSizes.at(1));
+    EXPECT_EQ(fineSizes.at(1), originalSizes.at(1));
+    EXPECT_EQ(coarseSizes.at(2), originalSizes.at(2));
+
+    std::filesystem::remove(pyramidPath);
+}
+
+TEST_F(PyramidBuilderTest, PointsCanNotBeSimplified)
+{
+    auto table = InitializeDbWithEmptyGeometryTable("pois", "POINT", SpatialIndex::RTree);
+
+    EXPECT_THROW(std::ignore = BuildPyramid({"pois"}, {8}), std::runtime_error);
+}
+
+TEST_F(PyramidBuilderTest, LevelsOfTableWithoutPrimaryKeyAreKeyedByRowid)
+{
+    Execute("CREATE TABLE rivers (name TEXT);");
+    Execute(fmt::format("SELECT AddGeometryColumn('rivers', 'geometry', {}, 'LINESTRING', 'XY');", Wgs84Srid));
+    Execute(fmt::format(R"SQL(
+        INSERT INTO rivers (rowid, name, geometry) VALUES 
+            (5, 'first', GeomFromText('LINESTRING(0 0, 1 1)', {0})),
+            (9, 'second', GeomFromText('LINESTRING(10 10, 20 20)', {0}));
+    )SQL", Wgs84Srid));
+    InitializeDb();
+
+    const auto pyramidPath = BuildPyramid({"rivers"}, {6});
+    {
+        const Database pyramidDb{pyramidPath, GetDbPath()};
+        const auto levels = pyramidDb.GetPyramidLevels();
+        ASSERT_EQ(levels.size(), 1);
+        TableInfo levelInfo{levels[0].levelTable, pyramidDb};
+        levelInfo.geometryType = GeometryType::Line;
+        levelInfo.dimension = Dimension::XY;
+        const auto sizes = GetBlobSizes(pyramidDb, levelInfo);
+        EXPECT_EQ(sizes.size(), 2);
+        EXPECT_TRUE(sizes.contains(5));
+        EXPECT_TRUE(sizes.contains(9));
+    }
+
+    std::filesystem::remove(pyramidPath);
+    Execute("SELECT DiscardGeometryColumn('rivers', 'geometry');");
+    Execute("DROP TABLE rivers;");
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "ConfigLoader.h"
+#include "DatabaseTestFixture.h"
+#include "QueryPlanAudit.h"
+
+#include <gtest/gtest.h>
+
+using namespace SpatialiteDatasource;
+
+class QueryPlanAuditTest : public DatabaseTestFixture {};
+
+TEST_F(QueryPlanAuditTest, LayerWithoutSpatialIndexScansTable)
+{
+    auto table = InitializeDbWithEmptyGeometryTable("my_table", "POINT", SpatialIndex::None);
+    table.Insert(::Geometry{"POINT(1 1)"});
+    table.Insert(::Geometry{"POINT(2 2)"});
+
+    const auto report = AuditQueryPlan(*spatialiteDb, table.UpdateAndGetTableInfo(GeometryType::Point, Dimension::XY));
+    ASSERT_EQ(report.fullScans.size(), 1);
+    EXPECT_EQ(report.fullScans[0].table, table.name);
+    EXPECT_EQ(report.fullScans[0].estimatedRows, 2);
+    EXPECT_EQ(report.estimatedRowsPerQuery, 2);
+}
+
+TEST_F(QueryPlanAuditTest, LayerWithSpatialIndexDoesNotScanTable)
+{
+    auto table = InitializeDbWithEmptyGeometryTable("my_table", "POINT", SpatialIndex::RTree);
+
+    const auto report = AuditQueryPlan(*spatialiteDb, table.UpdateAndGetTableInfo(GeometryType::Point, Dimension::XY));
+    EXPECT_FALSE(report.plan.empty());
+    EXPECT_TRUE(report.fullScans.empty());
+}
+
+TEST_F(QueryPlanAuditTest, RelationWithoutIndexScansTable)
+{
+    auto names = CreateTable("names", {{"feature_id", "INTEGER"}, {"name", "TEXT"}});
+    auto table = InitializeDbWithEmptyGeometryTable("my_table", "POINT", SpatialIndex::RTree);
+
+    auto& tableInfo = table.UpdateAndGetTableInfo(GeometryType::Point, Dimension::XY);
+    tableInfo.attributes = {
+        {"name", {ColumnType::Text, Relation{{"names.name"}, "|", "names.feature_id = layerTable.id"}}}
+    };
+
+    const auto report = AuditQueryPlan(*spatialiteDb, tableInfo);
+    ASSERT_EQ(report.fullScans.size(), 1);
+    EXPECT_EQ(report.fullScans[0].table, names.name);
+}
+
+TEST_F(QueryPlanAuditTest, AuditFailsOnFullScanIfConfigured)
+{
+    auto table = InitializeDbWithEmptyGeometryTable("my_table", "POINT", SpatialIndex::None);
+    const auto& tableInfo = table.UpdateAndGetTableInfo(GeometryType::Point, Dimension::XY);
+
+    EXPECT_NO_THROW(AuditQueryPlans(*spatialiteDb, {&tableInfo}, {.onFullScan = FullScanPolicy::Warn}));
+    EXPECT_THROW(AuditQueryPlans(*spatialiteDb, {&tableInfo}, {.onFullScan = FullScanPolicy::Fail}), 
+        std::runtime_error);
+}
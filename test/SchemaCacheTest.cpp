@@ -0,0 +1,122 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "SchemaCache.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+SchemaSnapshot CreateSnapshot()
+{
+    SchemaSnapshot snapshot;
+    snapshot.datasourceConfig = {{"mapId", "map"}, {"layers", nlohmann::json::object()}};
+
+    TableInfo tableInfo;
+    tableInfo.name = "roads";
+    tableInfo.primaryKey = "id";
+    tableInfo.geometryColumn = "geometry";
+    tableInfo.geometryType = GeometryType::Line;
+    tableInfo.dimension = Dimension::XYZ;
+    tableInfo.spatialIndex = SpatialIndex::RTree;
+    tableInfo.scaling = {1, 2, 3};
+    tableInfo.attributes["name"] = {.type = ColumnType::Text};
+    tableInfo.attributes["signs"] = {
+        .type = ColumnType::Int64, 
+        .relation = Relation{{"signs.id", "signs.type"}, ";", "signs.road = roads.id"}};
+    snapshot.tablesInfo.emplace(tableInfo.name, tableInfo);
+    return snapshot;
+}
+
+class SchemaCacheTest : public testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        std::filesystem::remove(cachePath);
+    }
+
+    const std::filesystem::path cachePath = std::filesystem::temp_directory_path() / "schema_cache_test.json";
+};
+
+} // namespace
+
+TEST_F(SchemaCacheTest, SnapshotIsRestored)
+{
+    const auto snapshot = CreateSnapshot();
+    StoreSchemaSnapshot(cachePath, "fingerprint", snapshot);
+
+    const auto loaded = LoadSchemaSnapshot(cachePath, "fingerprint");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->datasourceConfig, snapshot.datasourceConfig);
+    EXPECT_EQ(loaded->tablesInfo, snapshot.tablesInfo);
+}
+
+TEST_F(SchemaCacheTest, ConcurrentlyStoredSnapshotIsComplete)
+{
+    const auto snapshot = CreateSnapshot();
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; ++i)
+    {
+        writers.emplace_back([&] { StoreSchemaSnapshot(cachePath, "fingerprint", snapshot); });
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+
+    const auto loaded = LoadSchemaSnapshot(cachePath, "fingerprint");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->tablesInfo, snapshot.tablesInfo);
+}
+
+TEST_F(SchemaCacheTest, SnapshotOfAnotherFingerprintIsIgnored)
+{
+    StoreSchemaSnapshot(cachePath, "fingerprint", CreateSnapshot());
+    EXPECT_FALSE(LoadSchemaSnapshot(cachePath, "another fingerprint").has_value());
+}
+
+TEST_F(SchemaCacheTest, CorruptedSnapshotIsIgnored)
+{
+    std::ofstream{cachePath} << R"({"version": 1, "fingerprint": "fingerprint", "tables": [)";
+    EXPECT_FALSE(LoadSchemaSnapshot(cachePath, "fingerprint").has_value());
+}
+
+TEST_F(SchemaCacheTest, MissingSnapshotIsIgnored)
+{
+    EXPECT_FALSE(LoadSchemaSnapshot(cachePath, "fingerprint").has_value());
+}
+
+TEST(SchemaFingerprintTest, DatabaseIdentityChangesWithFile)
+{
+    const auto dbPath = std::filesystem::temp_directory_path() / "schema_fingerprint_test.sqlite";
+    std::ofstream{dbPath} << "data";
+    const auto identity = GetDatabaseIdentity(dbPath);
+    std::ofstream{dbPath, std::ios::app} << "more data";
+    EXPECT_NE(GetDatabaseIdentity(dbPath), identity);
+    std::filesystem::remove(dbPath);
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "SingleFlight.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <latch>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using SpatialiteDatasource::SingleFlight;
+
+TEST(SingleFlightTest, ValueIsComputedByTheCaller)
+{
+    SingleFlight<int, int> singleFlight;
+    const auto result = singleFlight.Do(1, [] { return 42; });
+    EXPECT_EQ(result.value, 42);
+    EXPECT_FALSE(result.isShared);
+}
+
+TEST(SingleFlightTest, ConcurrentCallsWithSameKeyAreCoalesced)
+{
+    constexpr int Callers = 8;
+    SingleFlight<int, int> singleFlight;
+    std::atomic<int> calls{0};
+    std::atomic<int> sharedResults{0};
+    std::latch waitersStarted{Callers - 1};
+    std::latch computationStarted{1};
+
+    std::thread leader{[&] {
+        const auto result = singleFlight.Do(1, [&] {
+            computationStarted.count_down();
+            waitersStarted.wait();
+            ++calls;
+            return 42;
+        });
+        EXPECT_EQ(result.value, 42);
+    }};
+    computationStarted.wait();
+
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < Callers - 1; ++i)
+    {
+        waiters.emplace_back([&] {
+            waitersStarted.count_down();
+            const auto result = singleFlight.Do(1, [&] { ++calls; return 42; });
+            if (result.isShared)
+                ++sharedResults;
+            EXPECT_EQ(result.value, 42);
+        });
+    }
+    leader.join();
+    for (auto& waiter : waiters)
+        waiter.join();
+
+    // waiters that came after the leader had finished compute their own value
+    EXPECT_EQ(calls + sharedResults, Callers);
+}
+
+TEST(SingleFlightTest, CallsWithDifferentKeysAreNotCoalesced)
+{
+    SingleFlight<int, int> singleFlight;
+    const auto first = singleFlight.Do(1, [&] {
+        return singleFlight.Do(2, [] { return 2; }).value + 1;
+    });
+    EXPECT_EQ(first.value, 3);
+    EXPECT_FALSE(first.isShared);
+}
+
+TEST(SingleFlightTest, ExceptionIsRethrownAndKeyIsReleased)
+{
+    SingleFlight<int, int> singleFlight;
+    EXPECT_THROW(singleFlight.Do(1, []() -> int { throw std::runtime_error{"failure"}; }), std::runtime_error);
+    EXPECT_EQ(singleFlight.Do(1, [] { return 1; }).value, 1);
+}
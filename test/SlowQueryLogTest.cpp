@@ -0,0 +1,73 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "ConfigLoader.h"
+#include "SlowQueryLog.h"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using namespace SpatialiteDatasource;
+using namespace std::chrono_literals;
+
+namespace {
+
+[[nodiscard]] SlowQuery MakeQuery(const std::string& table)
+{
+    SlowQuery query;
+    query.table = table;
+    query.sql = "SELECT 1";
+    query.plan = {"SCAN " + table};
+    query.rows = 1;
+    query.totalTime = 1s;
+    return query;
+}
+
+} // namespace
+
+TEST(SlowQueryLogTest, NothingIsSlowWhenDisabled)
+{
+    const SlowQueryLog log{SlowQueryLogOptions{}};
+    EXPECT_FALSE(log.IsSlow(1h));
+}
+
+TEST(SlowQueryLogTest, QueriesAboveThresholdAreSlow)
+{
+    const SlowQueryLog log{{.threshold = 100ms, .capacity = 4}};
+    EXPECT_FALSE(log.IsSlow(99ms));
+    EXPECT_TRUE(log.IsSlow(100ms));
+}
+
+TEST(SlowQueryLogTest, LatestQueriesAreKept)
+{
+    SlowQueryLog log{{.threshold = 100ms, .capacity = 2}};
+    log.Record(MakeQuery("a"));
+    log.Record(MakeQuery("b"));
+    log.Record(MakeQuery("c"));
+
+    const auto queries = nlohmann::json::parse(log.Dump());
+    ASSERT_EQ(queries.size(), 2);
+    EXPECT_EQ(queries[0]["table"], "b");
+    EXPECT_EQ(queries[1]["table"], "c");
+    EXPECT_EQ(queries[1]["plan"][0], "SCAN c");
+    EXPECT_EQ(queries[1]["rows"], 1);
+    EXPECT_DOUBLE_EQ(queries[1]["totalMs"].get<double>(), 1000.);
+}
@@ -24,7 +24,11 @@
 #include <spatialite.h>
 
 TestDbDriver::TestDbDriver()
-    : m_dbPath{std::filesystem::temp_directory_path() / std::tmpnam(nullptr)}
+    : TestDbDriver{std::filesystem::temp_directory_path() / std::tmpnam(nullptr)}
+{}
+
+TestDbDriver::TestDbDriver(std::filesystem::path dbPath)
+    : m_dbPath{std::move(dbPath)}
     , m_db{m_dbPath, SQLite::OPEN_CREATE | SQLite::OPEN_READWRITE}
 {
     m_spatialiteCache = spatialite_alloc_connection();
@@ -52,3 +56,13 @@ const std::filesystem::path& TestDbDriver::GetPath() const noexcept
 {
     return m_dbPath;
 }
+
+void TestDbDriver::Execute(const std::string& sql)
+{
+    m_db.exec(sql);
+}
+
+[[nodiscard]] SQLite::Database& TestDbDriver::GetDatabase() noexcept
+{
+    return m_db;
+}
@@ -34,10 +34,13 @@ class TestDbDriver
 {
 public:
     TestDbDriver();
+    explicit TestDbDriver(std::filesystem::path dbPath);
     ~TestDbDriver();
 
     [[nodiscard]] Table CreateTable(std::string_view tableName, const std::vector<Column>& columns);
     [[nodiscard]] const std::filesystem::path& GetPath() const noexcept;
+    void Execute(const std::string& sql);
+    [[nodiscard]] SQLite::Database& GetDatabase() noexcept;
 
 private:
     void InitNavInfoMetaData();
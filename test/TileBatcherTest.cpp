@@ -0,0 +1,154 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "FeatureBudget.h"
+#include "LevelOfDetail.h"
+#include "TileBatcher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+BufferedFeature CreatePointFeature(int id, const Mbr& tileMbr)
+{
+    BufferedFeature feature{id};
+    feature.AddGeometry(GeometryType::Point, 1).AddPoint({
+        (tileMbr.xmin + tileMbr.xmax) / 2, 
+        (tileMbr.ymin + tileMbr.ymax) / 2});
+    return feature;
+}
+
+std::vector<int> GetIds(const TileFeatures& tileFeatures)
+{
+    std::vector<int> ids;
+    for (const auto* feature : tileFeatures.features)
+        ids.push_back(feature->GetId());
+    return ids;
+}
+
+} // namespace
+
+TEST(TileBatcherTest, TileIsReadDirectlyIfBatchingIsDisabled)
+{
+    const mapget::TileId tileId{10, 10, 5};
+    int reads = 0;
+    TileBatcher batcher{{}, [&](const TableInfo&, const Mbr& mbr, uint16_t) {
+        ++reads;
+        const auto tileMbr = GetTileMbr(tileId);
+        EXPECT_DOUBLE_EQ(mbr.xmin, tileMbr.xmin);
+        EXPECT_DOUBLE_EQ(mbr.ymax, tileMbr.ymax);
+        BufferedFeatures features;
+        features.push_back(CreatePointFeature(1, tileMbr));
+        return features;
+    }};
+
+    TableInfo tableInfo;
+    tableInfo.name = "table";
+    const auto tileFeatures = batcher.Read(tableInfo, tileId);
+    EXPECT_EQ(reads, 1);
+    EXPECT_EQ(GetIds(*tileFeatures), std::vector{1});
+}
+
+TEST(TileBatcherTest, AdjacentTilesAreReadWithSingleQuery)
+{
+    const mapget::TileId firstTile{10, 10, 5};
+    const mapget::TileId secondTile{11, 10, 5};
+    std::atomic<int> reads = 0;
+    TileBatchingOptions options{.window = std::chrono::milliseconds{500}, .maxTiles = 4};
+    TileBatcher batcher{options, [&](const TableInfo&, const Mbr&, uint16_t) {
+        ++reads;
+        BufferedFeatures features;
+        features.push_back(CreatePointFeature(1, GetTileMbr(firstTile)));
+        features.push_back(CreatePointFeature(2, GetTileMbr(secondTile)));
+        return features;
+    }};
+
+    TableInfo tableInfo;
+    tableInfo.name = "table";
+    std::shared_ptr<const TileFeatures> firstTileFeatures, secondTileFeatures;
+    std::thread first{[&] { firstTileFeatures = batcher.Read(tableInfo, firstTile); }};
+    std::thread second{[&] { secondTileFeatures = batcher.Read(tableInfo, secondTile); }};
+    first.join();
+    second.join();
+
+    EXPECT_EQ(reads, 1);
+    EXPECT_EQ(firstTileFeatures->buffer, secondTileFeatures->buffer);
+    EXPECT_EQ(GetIds(*firstTileFeatures), std::vector{1});
+    EXPECT_EQ(GetIds(*secondTileFeatures), std::vector{2});
+}
+
+TEST(TileBatcherTest, TilesOfDifferentZoomLevelsAreNotBatched)
+{
+    std::atomic<int> reads = 0;
+    TileBatchingOptions options{.window = std::chrono::milliseconds{100}, .maxTiles = 4};
+    TileBatcher batcher{options, [&](const TableInfo&, const Mbr&, uint16_t) {
+        ++reads;
+        return BufferedFeatures{};
+    }};
+
+    TableInfo tableInfo;
+    tableInfo.name = "table";
+    std::thread first{[&] { static_cast<void>(batcher.Read(tableInfo, {10, 10, 5})); }};
+    std::thread second{[&] { static_cast<void>(batcher.Read(tableInfo, {20, 20, 6})); }};
+    first.join();
+    second.join();
+
+    EXPECT_EQ(reads, 2);
+}
+
+TEST(TileBatcherTest, DenseTileDoesNotUseUpBudgetOfBatchedTiles)
+{
+    const mapget::TileId denseTile{10, 10, 5};
+    const mapget::TileId sparseTile{11, 10, 5};
+    const LayerOptions layerOptions{.maxFeatures = 2, .importance = FeatureImportance::Order};
+    TileBatchingOptions options{.window = std::chrono::milliseconds{500}, .maxTiles = 4};
+    TileBatcher batcher{options, [&](const TableInfo& tableInfo, const Mbr& mbr, uint16_t zoom) {
+        // the query returns the rows of the dense tile first and stops at the read limit like the decode pipeline
+        const auto levelOfDetail = GetReadLevelOfDetail(layerOptions, tableInfo, mbr, zoom);
+        BufferedFeatures features;
+        for (int id = 1; id <= 11 && !levelOfDetail.IsReadLimitReached(features.size(), 0); ++id)
+        {
+            features.push_back(CreatePointFeature(id, GetTileMbr(id <= 10 ? denseTile : sparseTile)));
+        }
+        return features;
+    }};
+
+    TableInfo tableInfo;
+    tableInfo.name = "table";
+    tableInfo.geometryType = GeometryType::Point;
+    std::shared_ptr<const TileFeatures> denseTileFeatures, sparseTileFeatures;
+    std::thread dense{[&] { denseTileFeatures = batcher.Read(tableInfo, denseTile); }};
+    std::thread sparse{[&] { sparseTileFeatures = batcher.Read(tableInfo, sparseTile); }};
+    dense.join();
+    sparse.join();
+
+    ASSERT_EQ(denseTileFeatures->buffer, sparseTileFeatures->buffer);
+    const auto denseSelected = SelectFeaturesWithinBudget(denseTileFeatures->features, layerOptions, GeometryType::Point);
+    ASSERT_TRUE(denseSelected.has_value());
+    EXPECT_EQ(denseSelected->size(), 2);
+    EXPECT_EQ(GetIds(*sparseTileFeatures), std::vector{11});
+    EXPECT_FALSE(SelectFeaturesWithinBudget(sparseTileFeatures->features, layerOptions, GeometryType::Point).has_value());
+}
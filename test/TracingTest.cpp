@@ -0,0 +1,119 @@
+// Copyright (c) 2025 NavInfo Europe B.V.
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "ConfigLoader.h"
+#include "Tracing.h"
+
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace SpatialiteDatasource;
+
+namespace {
+
+[[nodiscard]] std::filesystem::path GetTracePath(const std::string& name)
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+[[nodiscard]] std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream file{path};
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+TEST(TracingTest, NothingIsTracedWhenDisabled)
+{
+    Tracer tracer{TracingOptions{}};
+    EXPECT_EQ(tracer.StartTrace(), nullptr);
+
+    ScopedSpan span{"tile"};
+    EXPECT_FALSE(span.IsActive());
+}
+
+TEST(TracingTest, SpansAreWrittenAsJsonLines)
+{
+    const auto path = GetTracePath("spatialite-datasource-trace.jsonl");
+    {
+        Tracer tracer{{.path = path, .format = TraceFormat::JsonLines, .sampleRate = 1.}};
+        const auto trace = tracer.StartTrace();
+        ASSERT_NE(trace, nullptr);
+        const TraceScope traceScope{trace.get()};
+        ScopedSpan tileSpan{"tile"};
+        {
+            ScopedSpan span{"decode"};
+            ASSERT_TRUE(span.IsActive());
+            span.SetArg("rows", 3);
+        }
+        std::thread{[trace = Trace::Current()] {
+            const TraceScope workerScope{trace};
+            ScopedSpan span{"step"};
+        }}.join();
+    }
+    EXPECT_EQ(Trace::Current(), nullptr);
+
+    std::istringstream lines{ReadFile(path)};
+    std::vector<nlohmann::json> spans;
+    for (std::string line; std::getline(lines, line);)
+    {
+        spans.push_back(nlohmann::json::parse(line));
+    }
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(spans.size(), 3);
+    EXPECT_EQ(spans[0]["name"], "decode");
+    EXPECT_EQ(spans[0]["args"]["rows"], 3);
+    EXPECT_EQ(spans[1]["name"], "step");
+    EXPECT_NE(spans[1]["thread"], spans[0]["thread"]);
+    EXPECT_EQ(spans[2]["name"], "tile");
+    EXPECT_EQ(spans[2]["trace"], spans[0]["trace"]);
+    EXPECT_LE(spans[2]["startUs"].get<int64_t>(), spans[0]["startUs"].get<int64_t>());
+}
+
+TEST(TracingTest, SpansAreWrittenAsChromeTraceEvents)
+{
+    const auto path = GetTracePath("spatialite-datasource-trace.json");
+    {
+        Tracer tracer{{.path = path, .format = TraceFormat::Chrome, .sampleRate = 1.}};
+        const auto trace = tracer.StartTrace();
+        const TraceScope traceScope{trace.get()};
+        ScopedSpan span{"tile"};
+    }
+
+    auto content = ReadFile(path);
+    std::filesystem::remove(path);
+    // the closing bracket is optional for the viewers, but not for the parser
+    content.erase(content.find_last_of(','));
+    const auto events = nlohmann::json::parse(content + "]");
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0]["name"], "tile");
+    EXPECT_EQ(events[0]["ph"], "X");
+    EXPECT_TRUE(events[0].contains("dur"));
+}